@@ -6,6 +6,18 @@
 #include <sstream>    // For reading in CSV file and splitting by commas
 #include <algorithm>  // For find(), which searches within a vector
 #include <cstdlib>    // For abs()
+#include <cmath>      // For ceil()
+#include <cstdio>     // For remove(), to delete the benchmark file
+#include <thread>     // For reading in large files with several threads
+#include <chrono>     // For timing the benchmarks
+#include <unordered_set> // For checking that winners advance to the next round
+#include <unordered_map> // For finding duplicate brackets in a pool
+#include <random>     // For generating synthetic data for the benchmarks
+#include <functional> // For evaluating different ways of predicting the winning region
+#include <atomic>     // For handing out seasons and resamples to the threads
+#include <cstdint>    // For the small number types in packed games
+#include <unistd.h>   // For fork() and pipe(), to measure memory in a process of its own
+#include <sys/wait.h> // For waitpid()
 using namespace std;  // To avoid prefacing cin/cout with std::
 
 
@@ -47,6 +59,210 @@ class TournamentRecord {
 };
 
 
+// A game packed into 16 bytes, for keeping large archives in memory. The team and region names are stored once
+// in the PackedArchive and referred to by number; ranks, rounds and game numbers have to fit in 8 bits and
+// scores in 16 bits (a blank score is read in as 0).
+struct PackedGame {
+    uint16_t team1, team2, winningTeam;
+    uint16_t score1, score2;
+    uint8_t rank1, rank2, numRound, numGame, region;
+    uint8_t unused;
+};
+static_assert(sizeof(PackedGame) == 16, "PackedGame should take 16 bytes");
+
+
+// Games packed with PackedGame, with the names they refer to. The analyses work on TournamentRecords,
+// so games are unpacked into TournamentRecords when they are needed, e.g. one season at a time.
+class PackedArchive {
+    public:
+        // Pack one game and add it to the end of the archive. Returns false, and adds nothing,
+        // if a value does not fit in a packed game.
+        bool appendGame(const string& region, int rank1, const string& team1, int score1, int rank2, const string& team2,
+                        int score2, const string& winningTeam, int numRound, int numGame) {
+            rebuildIds(teamNames, teamIds);
+            rebuildIds(regionNames, regionIds);
+            if (!fitsIn(rank1, 0xFF) || !fitsIn(rank2, 0xFF) || !fitsIn(numRound, 0xFF) || !fitsIn(numGame, 0xFF)
+              || !fitsIn(score1, 0xFFFF) || !fitsIn(score2, 0xFFFF)) {
+                return false;
+            }
+            // Check that there is room for the new names before adding any of them
+            int newTeams = isNew(teamIds, team1) + (team2 != team1 && isNew(teamIds, team2))
+                         + (winningTeam != team1 && winningTeam != team2 && isNew(teamIds, winningTeam));
+            if (teamNames.size() + newTeams > 0x10000 || regionNames.size() + isNew(regionIds, region) > 0x100) {
+                return false;
+            }
+            PackedGame game;
+            game.team1 = internName(teamNames, teamIds, team1);
+            game.team2 = internName(teamNames, teamIds, team2);
+            game.winningTeam = internName(teamNames, teamIds, winningTeam);
+            game.score1 = score1;
+            game.score2 = score2;
+            game.rank1 = rank1;
+            game.rank2 = rank2;
+            game.numRound = numRound;
+            game.numGame = numGame;
+            game.region = internName(regionNames, regionIds, region);
+            game.unused = 0;
+            games.push_back(game);
+            return true;
+        }
+
+        // Pack records and add them to the end of the archive. Returns false, and adds nothing (not even names),
+        // if a value does not fit in a packed game.
+        bool append(vector<TournamentRecord>& tournamentRecords) {
+            size_t oldGames = games.size(), oldTeams = teamNames.size(), oldRegions = regionNames.size();
+            for (int i = 0; i < tournamentRecords.size(); i++) {
+                TournamentRecord &oneRecord = tournamentRecords.at(i);
+                if (!appendGame(oneRecord.GetRegion(), oneRecord.GetRank1(), oneRecord.GetTeam1(), oneRecord.GetScore1(),
+                                oneRecord.GetRank2(), oneRecord.GetTeam2(), oneRecord.GetScore2(), oneRecord.GetWinningTeam(),
+                                oneRecord.GetNumRound(), oneRecord.GetNumGame())) {
+                    truncate(oldGames, oldTeams, oldRegions);
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Add the games of another archive to the end of this one, e.g. the archives packed by several threads.
+        // Returns false, and adds nothing, if there are too many names.
+        bool append(PackedArchive& other) {
+            size_t oldGames = games.size(), oldTeams = teamNames.size(), oldRegions = regionNames.size();
+            rebuildIds(teamNames, teamIds);
+            rebuildIds(regionNames, regionIds);
+            vector<int> teamMap, regionMap;
+            for (int i = 0; i < other.teamNames.size(); i++) {
+                if (teamNames.size() == 0x10000 && isNew(teamIds, other.teamNames.at(i))) {
+                    truncate(oldGames, oldTeams, oldRegions);
+                    return false;
+                }
+                teamMap.push_back(internName(teamNames, teamIds, other.teamNames.at(i)));
+            }
+            for (int i = 0; i < other.regionNames.size(); i++) {
+                if (regionNames.size() == 0x100 && isNew(regionIds, other.regionNames.at(i))) {
+                    truncate(oldGames, oldTeams, oldRegions);
+                    return false;
+                }
+                regionMap.push_back(internName(regionNames, regionIds, other.regionNames.at(i)));
+            }
+            for (int i = 0; i < other.games.size(); i++) {
+                PackedGame game = other.games.at(i);
+                game.team1 = teamMap.at(game.team1);
+                game.team2 = teamMap.at(game.team2);
+                game.winningTeam = teamMap.at(game.winningTeam);
+                game.region = regionMap.at(game.region);
+                games.push_back(game);
+            }
+            return true;
+        }
+
+        // Give back the room left over from adding games, and the lookup of names to numbers, once the whole
+        // archive has been added (the lookup is built again if more games are added)
+        void shrinkToFit() {
+            games.shrink_to_fit();
+            unordered_map<string, int>().swap(teamIds);
+            unordered_map<string, int>().swap(regionIds);
+        }
+
+        int size() { return games.size(); }
+        PackedGame& getGame(int i) { return games.at(i); }
+        const string& getTeamName(int team) { return teamNames.at(team); }
+
+        // Unpack one game into a TournamentRecord
+        TournamentRecord at(int i) {
+            PackedGame &game = games.at(i);
+            TournamentRecord oneRecord;
+            oneRecord.SetRegion(regionNames.at(game.region));
+            oneRecord.SetRank1(game.rank1);
+            oneRecord.SetTeam1(teamNames.at(game.team1));
+            oneRecord.SetScore1(game.score1);
+            oneRecord.SetRank2(game.rank2);
+            oneRecord.SetTeam2(teamNames.at(game.team2));
+            oneRecord.SetScore2(game.score2);
+            oneRecord.SetWinningTeam(teamNames.at(game.winningTeam));
+            oneRecord.SetNumRound(game.numRound);
+            oneRecord.SetNumGame(game.numGame);
+            return oneRecord;
+        }
+
+        // Unpack the games from first up to (not including) last, e.g. one season, so the analyses can run on them
+        void unpack(int first, int last, vector<TournamentRecord>& tournamentRecords) {
+            tournamentRecords.clear();
+            for (int i = first; i < last; i++) {
+                tournamentRecords.push_back(at(i));
+            }
+        }
+
+        // Memory used by the games, the names and the lookup of names to numbers (while there is one)
+        size_t getBytesUsed() {
+            return games.capacity() * sizeof(PackedGame) + namesBytes(teamNames, teamIds) + namesBytes(regionNames, regionIds);
+        }
+
+    private:
+        // Memory used by a list of names and its lookup: each string, with the name itself if it is too long to fit
+        // inside the string, and in the lookup another copy of the string, the number, the link to the next entry
+        // and the saved hash of each entry, and one pointer per bucket
+        size_t namesBytes(vector<string>& names, unordered_map<string, int>& ids) {
+            size_t numBytes = names.capacity() * sizeof(string) + ids.bucket_count() * sizeof(void*);
+            for (int i = 0; i < names.size(); i++) {
+                size_t heapBytes = (names.at(i).size() > 15) ? names.at(i).size() + 1 : 0;
+                numBytes += heapBytes;
+                if (!ids.empty()) {
+                    numBytes += sizeof(pair<const string, int>) + sizeof(void*) + sizeof(size_t) + heapBytes;
+                }
+            }
+            return numBytes;
+        }
+
+        // Build the lookup of names to numbers again, after shrinkToFit() let go of it
+        void rebuildIds(vector<string>& names, unordered_map<string, int>& ids) {
+            if (ids.empty()) {
+                for (int i = 0; i < names.size(); i++) {
+                    ids[names.at(i)] = i;
+                }
+            }
+        }
+
+        bool isNew(unordered_map<string, int>& ids, const string& name) {
+            return ids.find(name) == ids.end();
+        }
+
+        // Number of a name, adding it if it is new (the caller checks that there is room for it)
+        int internName(vector<string>& names, unordered_map<string, int>& ids, const string& name) {
+            unordered_map<string, int>::iterator found = ids.find(name);
+            if (found != ids.end()) {
+                return found->second;
+            }
+            ids[name] = names.size();
+            names.push_back(name);
+            return names.size() - 1;
+        }
+
+        // Go back to the given numbers of games and names, forgetting the names added since
+        void truncate(size_t numGames, size_t numTeams, size_t numRegions) {
+            games.resize(numGames);
+            while (teamNames.size() > numTeams) {
+                teamIds.erase(teamNames.back());
+                teamNames.pop_back();
+            }
+            while (regionNames.size() > numRegions) {
+                regionIds.erase(regionNames.back());
+                regionNames.pop_back();
+            }
+        }
+
+        // Whether a number fits from 0 up to maxValue
+        bool fitsIn(int number, int maxValue) {
+            return number >= 0 && number <= maxValue;
+        }
+
+        vector<PackedGame> games;
+        vector<string> teamNames;
+        unordered_map<string, int> teamIds;
+        vector<string> regionNames;
+        unordered_map<string, int> regionIds;
+};
+
+
 //--------------------------------------------------------------------------------
 // Display welcome message, introducing the user to the program
 void displayWelcomeMessage()
@@ -130,20 +346,597 @@ void readInTournamentData(string filename, vector<TournamentRecord>& tournamentR
 } // end readInTournamentData()
 
 
+// Kinds of problems the loader can find in a file
+enum LoadErrorCode {
+    ERROR_FILE_NOT_OPENED = 1,
+    ERROR_COLUMN_COUNT,           // the line does not have exactly 10 columns
+    ERROR_NOT_A_NUMBER,           // a rank, score, round or game column is not a number
+    ERROR_OUT_OF_RANGE,           // a rank, score, round or game number is outside the range a tournament can have
+    ERROR_WINNER_NOT_A_TEAM,      // the winning team is neither of the teams that played
+    ERROR_WINNER_DOES_NOT_ADVANCE // the winning team does not play in the next round
+};
+
+// One problem found in a file. The game on a rejected line is left out of the vector;
+// the other problems are reported, but the game is still read in.
+struct LoadError {
+    int lineNumber;
+    LoadErrorCode code;
+    string message;
+    bool rowRejected;
+};
+
+// The highest round number that is accepted, far more than a bracket of any size needs.
+// Round 0 holds play-in games, such as the First Four.
+const int MAX_ROUND = 64;
+
+
+// The columns of the records parsed by one thread, kept in their own vectors until they are merged
+struct TournamentColumns {
+    vector<string> regions, teams1, teams2, winningTeams;
+    vector<int> ranks1, ranks2, scores1, scores2, numRounds, numGames;
+    vector<int> lineNumbers;   // line within the chunk that each record came from
+    int numLines = 0;          // lines read in this chunk, to work out line numbers in the file
+    vector<LoadError> errors;  // with line numbers within the chunk
+    bool packFailed = false;   // a record did not fit in a packed game, when packing
+};
+
+
+//--------------------------------------------------------------------------------
+// Convert a column to a number without throwing, so a bad value can be reported instead
+bool parseNumber(const string &columnVal, int &number)
+{
+    if (columnVal.empty() || columnVal.size() > 9) {
+        return false;
+    }
+    number = 0;
+    for (int i = 0; i < columnVal.size(); i++) {
+        if (columnVal[i] < '0' || columnVal[i] > '9') {
+            return false;
+        }
+        number = number * 10 + (columnVal[i] - '0');
+    }
+    return true;
+} // end parseNumber()
+
+
+//--------------------------------------------------------------------------------
+// Remove spaces around a team or region name, e.g. "Iowa " in the 2022 Women's file
+void trimSpaces(string &columnVal)
+{
+    size_t first = columnVal.find_first_not_of(" \t");
+    size_t last = columnVal.find_last_not_of(" \t");
+    if (first == string::npos) {
+        columnVal.clear();
+    } else if (first > 0 || last + 1 < columnVal.size()) {
+        columnVal = columnVal.substr(first, last - first + 1);
+    }
+} // end trimSpaces()
+
+
+//--------------------------------------------------------------------------------
+// Parse the lines between two byte offsets of the file data into columns, checking each
+// line as it is parsed. Both offsets are at the start of a line (or the end of the data).
+// If packedRows is given, the records are packed into it instead, and only their line numbers are kept in the columns;
+// parsing stops at the first record that does not fit in a packed game.
+void parseTournamentChunk(const string &data, size_t chunkStart, size_t chunkEnd, TournamentColumns &columns, bool validate,
+                          PackedArchive *packedRows = NULL)
+{
+    size_t lineStart = chunkStart;
+    while (lineStart < chunkEnd) {
+        size_t lineEnd = data.find('\n', lineStart);
+        if (lineEnd == string::npos || lineEnd > chunkEnd) {
+            lineEnd = chunkEnd;
+        }
+        columns.numLines++;
+        int lineNumber = columns.numLines;
+
+        // Ignore a carriage return at the end of the line, and skip blank lines
+        size_t contentEnd = lineEnd;
+        if (contentEnd > lineStart && data[contentEnd - 1] == '\r') {
+            contentEnd--;
+        }
+        size_t nextLineStart = lineEnd + 1;
+        if (contentEnd == lineStart) {
+            lineStart = nextLineStart;
+            continue;
+        }
+
+        // separate the line by commas into each column
+        string columnVals[10];
+        int colNum = 0;
+        size_t columnStart = lineStart;
+        while (true) {
+            size_t comma = data.find(',', columnStart);
+            size_t columnEnd = (comma == string::npos || comma > contentEnd) ? contentEnd : comma;
+            if (colNum < 10) {
+                columnVals[colNum].assign(data, columnStart, columnEnd - columnStart);
+            }
+            colNum++;
+            if (columnEnd == contentEnd) {
+                break;
+            }
+            columnStart = columnEnd + 1;
+        }
+        lineStart = nextLineStart;
+
+        if (colNum != 10) {
+            columns.errors.push_back({lineNumber, ERROR_COLUMN_COUNT,
+                "Expected 10 columns but found " + to_string(colNum), true});
+            continue;
+        }
+
+        // the scores are blank in prediction files
+        int rank1, rank2, score1 = 0, score2 = 0, numRound, numGame;
+        if (!parseNumber(columnVals[1], rank1) || !parseNumber(columnVals[4], rank2)
+          || (columnVals[3] != "" && !parseNumber(columnVals[3], score1))
+          || (columnVals[6] != "" && !parseNumber(columnVals[6], score2))
+          || !parseNumber(columnVals[8], numRound) || !parseNumber(columnVals[9], numGame)) {
+            columns.errors.push_back({lineNumber, ERROR_NOT_A_NUMBER,
+                "Expected a number in a rank, score, round or game column", true});
+            continue;
+        }
+        for (int col : {0, 2, 5, 7}) {
+            trimSpaces(columnVals[col]);
+        }
+
+        if (validate) {
+            // The shape of the bracket is not known yet, so only check what holds for any bracket
+            if (rank1 < 1 || rank2 < 1) {
+                columns.errors.push_back({lineNumber, ERROR_OUT_OF_RANGE, "Ranks must be 1 or more", true});
+                continue;
+            }
+            if (numRound < 0 || numRound > MAX_ROUND || numGame < 1) {
+                columns.errors.push_back({lineNumber, ERROR_OUT_OF_RANGE,
+                    "Round " + to_string(numRound) + ", Game " + to_string(numGame) + " does not exist in the tournament", true});
+                continue;
+            }
+            if (columnVals[7] != columnVals[2] && columnVals[7] != columnVals[5]) {
+                columns.errors.push_back({lineNumber, ERROR_WINNER_NOT_A_TEAM,
+                    "The winning team " + columnVals[7] + " is neither " + columnVals[2] + " nor " + columnVals[5], true});
+                continue;
+            }
+        }
+
+        if (packedRows != NULL) {
+            if (!packedRows->appendGame(columnVals[0], rank1, columnVals[2], score1, rank2, columnVals[5], score2,
+                                        columnVals[7], numRound, numGame)) {
+                columns.packFailed = true;
+                return;
+            }
+            columns.lineNumbers.push_back(lineNumber);
+            continue;
+        }
+
+        columns.regions.push_back(move(columnVals[0]));
+        columns.ranks1.push_back(rank1);
+        columns.teams1.push_back(move(columnVals[2]));
+        columns.scores1.push_back(score1);
+        columns.ranks2.push_back(rank2);
+        columns.teams2.push_back(move(columnVals[5]));
+        columns.scores2.push_back(score2);
+        columns.winningTeams.push_back(move(columnVals[7]));
+        columns.numRounds.push_back(numRound);
+        columns.numGames.push_back(numGame);
+        columns.lineNumbers.push_back(lineNumber);
+    }
+} // end parseTournamentChunk()
+
+
+//--------------------------------------------------------------------------------
+// Read in the whole file and parse it using several threads. The file is split into chunks at line breaks, and
+// each chunk is parsed and checked by its own thread. If packedChunks is given, each thread packs its records into
+// its own archive. firstLines gets the line number in the file to add to the line numbers within each chunk, and the
+// errors are added with line numbers in the file. Returns false if the file could not be opened.
+bool parseTournamentFile(string filename, vector<TournamentColumns>& chunks, vector<int>& firstLines,
+                         vector<LoadError>& errors, int numThreads, bool validate, vector<PackedArchive> *packedChunks = NULL) {
+
+    ifstream inStream;
+    inStream.open(filename, ios::binary);
+    if (inStream.fail()) {
+        errors.push_back({0, ERROR_FILE_NOT_OPENED, "Could not open " + filename, true});
+        return false;
+    }
+
+    // read in the whole file at once
+    string data;
+    inStream.seekg(0, ios::end);
+    data.resize(inStream.tellg());
+    inStream.seekg(0, ios::beg);
+    inStream.read(&data[0], data.size());
+
+    // skip the header
+    size_t dataStart = data.find('\n');
+    dataStart = (dataStart == string::npos) ? data.size() : dataStart + 1;
+
+    // Split the rest into one chunk per thread, moving each split point to the start of the next line
+    vector<size_t> chunkStarts;
+    chunkStarts.push_back(dataStart);
+    for (int t = 1; t < numThreads; t++) {
+        size_t splitPoint = dataStart + (data.size() - dataStart) * t / numThreads;
+        if (splitPoint > chunkStarts.back()) {
+            splitPoint = data.find('\n', splitPoint - 1);
+            splitPoint = (splitPoint == string::npos) ? data.size() : splitPoint + 1;
+        } else {
+            splitPoint = chunkStarts.back();
+        }
+        chunkStarts.push_back(splitPoint);
+    }
+    chunkStarts.push_back(data.size());
+
+    // Parse each chunk on its own thread
+    chunks.assign(numThreads, TournamentColumns());
+    if (packedChunks != NULL) {
+        packedChunks->assign(numThreads, PackedArchive());
+    }
+    vector<thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        PackedArchive *packedRows = (packedChunks != NULL) ? &packedChunks->at(t) : NULL;
+        threads.push_back(thread(parseTournamentChunk, cref(data), chunkStarts.at(t), chunkStarts.at(t + 1), ref(chunks.at(t)),
+                                 validate, packedRows));
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads.at(t).join();
+    }
+
+    // Work out line numbers in the file (the header is line 1) and collect the errors in line order
+    firstLines.clear();
+    int lineNumber = 1;
+    for (int t = 0; t < numThreads; t++) {
+        firstLines.push_back(lineNumber);
+        for (int e = 0; e < chunks.at(t).errors.size(); e++) {
+            LoadError oneError = chunks.at(t).errors.at(e);
+            oneError.lineNumber += lineNumber;
+            errors.push_back(oneError);
+        }
+        lineNumber += chunks.at(t).numLines;
+    }
+    return true;
+} // end parseTournamentFile()
+
+
+//--------------------------------------------------------------------------------
+// Read in and check the tournament data using several threads. The file is split into chunks at line breaks,
+// each chunk is parsed and checked by its own thread, and the records are added to the vector in file order.
+// Problems are added to errors in line order instead of stopping the program. Returns false if the file could not be opened.
+bool readInTournamentDataParallel(string filename, vector<TournamentRecord>& tournamentRecords,
+                                  vector<LoadError>& errors, int numThreads, bool validate = true) {
+
+    vector<TournamentColumns> chunks;
+    vector<int> firstLines;
+    if (!parseTournamentFile(filename, chunks, firstLines, errors, numThreads, validate)) {
+        return false;
+    }
+
+    // Merge the chunks in file order; each thread fills in its own part of the vector
+    vector<size_t> recordStarts;
+    recordStarts.push_back(tournamentRecords.size());
+    for (int t = 0; t < numThreads; t++) {
+        recordStarts.push_back(recordStarts.back() + chunks.at(t).regions.size());
+    }
+    size_t firstNewRecord = recordStarts.front();
+    tournamentRecords.resize(recordStarts.back());
+    vector<int> recordLines(recordStarts.back() - firstNewRecord);
+
+    auto mergeChunk = [&](int t) {
+        TournamentColumns &columns = chunks.at(t);
+        for (size_t i = 0; i < columns.regions.size(); i++) {
+            TournamentRecord &oneRecord = tournamentRecords.at(recordStarts.at(t) + i);
+            oneRecord.SetRegion(move(columns.regions.at(i)));
+            oneRecord.SetRank1(columns.ranks1.at(i));
+            oneRecord.SetTeam1(move(columns.teams1.at(i)));
+            oneRecord.SetScore1(columns.scores1.at(i));
+            oneRecord.SetRank2(columns.ranks2.at(i));
+            oneRecord.SetTeam2(move(columns.teams2.at(i)));
+            oneRecord.SetScore2(columns.scores2.at(i));
+            oneRecord.SetWinningTeam(move(columns.winningTeams.at(i)));
+            oneRecord.SetNumRound(columns.numRounds.at(i));
+            oneRecord.SetNumGame(columns.numGames.at(i));
+            recordLines.at(recordStarts.at(t) - firstNewRecord + i) = firstLines.at(t) + columns.lineNumbers.at(i);
+        }
+    };
+    vector<thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.push_back(thread(mergeChunk, t));
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads.at(t).join();
+    }
+
+    // Check the bracket: every winner before the championship (the last round) has to play in the next round
+    if (validate) {
+        int lastRound = 0;
+        for (size_t i = firstNewRecord; i < tournamentRecords.size(); i++) {
+            lastRound = max(lastRound, tournamentRecords.at(i).GetNumRound());
+        }
+        vector< unordered_set<string> > teamsInRound(lastRound + 1);
+        for (size_t i = firstNewRecord; i < tournamentRecords.size(); i++) {
+            int numRound = tournamentRecords.at(i).GetNumRound();
+            teamsInRound.at(numRound).insert(tournamentRecords.at(i).GetTeam1());
+            teamsInRound.at(numRound).insert(tournamentRecords.at(i).GetTeam2());
+        }
+        for (size_t i = firstNewRecord; i < tournamentRecords.size(); i++) {
+            int numRound = tournamentRecords.at(i).GetNumRound();
+            if (numRound < lastRound
+              && teamsInRound.at(numRound + 1).count(tournamentRecords.at(i).GetWinningTeam()) == 0) {
+                errors.push_back({recordLines.at(i - firstNewRecord), ERROR_WINNER_DOES_NOT_ADVANCE,
+                    "The winning team " + tournamentRecords.at(i).GetWinningTeam() + " does not play in round " + to_string(numRound + 1), false});
+            }
+        }
+    }
+
+    stable_sort(errors.begin(), errors.end(), [](const LoadError &a, const LoadError &b) { return a.lineNumber < b.lineNumber; });
+    return true;
+} // end readInTournamentDataParallel()
+
+
+//--------------------------------------------------------------------------------
+// Read in and check an archive like readInTournamentDataParallel, but pack the games as they are parsed, so the
+// archive is never held as records. The archive is replaced by the games of the file. packed is set to false, the
+// archive is left empty and no errors are added if a game does not fit in a packed game; the file can then be read
+// in as records instead. Returns false if the file could not be opened.
+bool readInPackedArchive(string filename, PackedArchive& archive, vector<LoadError>& errors, int numThreads, bool& packed) {
+
+    vector<TournamentColumns> chunks;
+    vector<int> firstLines;
+    vector<PackedArchive> packedChunks;
+    vector<LoadError> fileErrors;
+    archive = PackedArchive();
+    packed = false;
+    if (!parseTournamentFile(filename, chunks, firstLines, fileErrors, numThreads, true, &packedChunks)) {
+        errors.insert(errors.end(), fileErrors.begin(), fileErrors.end());
+        return false;
+    }
+
+    // Add the chunks to the archive in file order
+    vector<int> gameLines;
+    for (int t = 0; t < numThreads; t++) {
+        if (chunks.at(t).packFailed || !archive.append(packedChunks.at(t))) {
+            archive = PackedArchive();
+            return true;
+        }
+        packedChunks.at(t) = PackedArchive();
+        for (int i = 0; i < chunks.at(t).lineNumbers.size(); i++) {
+            gameLines.push_back(firstLines.at(t) + chunks.at(t).lineNumbers.at(i));
+        }
+    }
+    archive.shrinkToFit();
+    packed = true;
+
+    // Check the bracket: every winner before the championship (the last round) has to play in the next round
+    int lastRound = 0;
+    for (int i = 0; i < archive.size(); i++) {
+        lastRound = max(lastRound, (int) archive.getGame(i).numRound);
+    }
+    vector< unordered_set<int> > teamsInRound(lastRound + 1);
+    for (int i = 0; i < archive.size(); i++) {
+        PackedGame &game = archive.getGame(i);
+        teamsInRound.at(game.numRound).insert(game.team1);
+        teamsInRound.at(game.numRound).insert(game.team2);
+    }
+    for (int i = 0; i < archive.size(); i++) {
+        PackedGame &game = archive.getGame(i);
+        if (game.numRound < lastRound && teamsInRound.at(game.numRound + 1).count(game.winningTeam) == 0) {
+            fileErrors.push_back({gameLines.at(i), ERROR_WINNER_DOES_NOT_ADVANCE,
+                "The winning team " + archive.getTeamName(game.winningTeam) + " does not play in round " + to_string(game.numRound + 1), false});
+        }
+    }
+
+    stable_sort(fileErrors.begin(), fileErrors.end(), [](const LoadError &a, const LoadError &b) { return a.lineNumber < b.lineNumber; });
+    errors.insert(errors.end(), fileErrors.begin(), fileErrors.end());
+    return true;
+} // end readInPackedArchive()
+
+
+//--------------------------------------------------------------------------------
+// Display the problems found in a file, and return whether any lines had to be left out
+bool displayLoadErrors(string filename, vector<LoadError>& errors) {
+
+    bool anyRowRejected = false;
+    for (int e = 0; e < errors.size(); e++) {
+        cout << filename;
+        if (errors.at(e).lineNumber > 0) {
+            cout << ", line " << errors.at(e).lineNumber;
+        }
+        cout << " [E" << errors.at(e).code << "]: " << errors.at(e).message
+             << (errors.at(e).rowRejected && errors.at(e).lineNumber > 0 ? " (line skipped)" : "") << "\n";
+        anyRowRejected = anyRowRejected || errors.at(e).rowRejected;
+    }
+    return anyRowRejected;
+} // end displayLoadErrors()
+
+
+//--------------------------------------------------------------------------------
+// Number of threads to use for parallel work
+int defaultNumThreads()
+{
+    int numThreads = thread::hardware_concurrency();
+    return (numThreads > 0) ? numThreads : 1;
+} // end defaultNumThreads()
+
+
+// The shape of a tournament, worked out from the games themselves instead of assuming 64 teams in 4 regions.
+// Each game is linked to the games that sent its teams to it (its sub-brackets), so play-in games (round 0,
+// such as the First Four) and teams with byes, which only start playing in a later round, are handled too.
+// The games are referred to by their position in the vector of records.
+class BracketEngine {
+    public:
+        // Build the bracket in linear time in the number of games
+        BracketEngine(vector<TournamentRecord>& tournamentRecords) {
+            int numGames = tournamentRecords.size();
+            parents.assign(numGames, -1);
+            subBrackets.assign(numGames, vector<int>());
+            regionIndexes.assign(numGames, -1);
+            championshipGame = -1;
+            firstRound = 0;
+            lastRound = -1;
+            mainRound = 0;
+            lastRegionalRound = -1;
+            if (numGames == 0) {
+                return;
+            }
+
+            // Group the games by round, keeping them in file order within a round
+            firstRound = lastRound = tournamentRecords.at(0).GetNumRound();
+            for (int i = 0; i < numGames; i++) {
+                firstRound = min(firstRound, tournamentRecords.at(i).GetNumRound());
+                lastRound = max(lastRound, tournamentRecords.at(i).GetNumRound());
+            }
+            gamesInRound.assign(lastRound - firstRound + 1, vector<int>());
+            for (int i = 0; i < numGames; i++) {
+                gamesInRound.at(tournamentRecords.at(i).GetNumRound() - firstRound).push_back(i);
+            }
+
+            // Going up one round at a time, each team came from the last game it won, if any
+            // (a team without one is playing its first game, e.g. after a bye)
+            unordered_map<string, int> lastGameWon;
+            for (int numRound = firstRound; numRound <= lastRound; numRound++) {
+                vector<int>& roundGames = getGamesInRound(numRound);
+                for (int g = 0; g < roundGames.size(); g++) {
+                    int game = roundGames.at(g);
+                    string teams[2] = {tournamentRecords.at(game).GetTeam1(), tournamentRecords.at(game).GetTeam2()};
+                    for (int t = 0; t < 2; t++) {
+                        unordered_map<string, int>::iterator found = lastGameWon.find(teams[t]);
+                        if (found != lastGameWon.end() && parents.at(found->second) == -1) {
+                            subBrackets.at(game).push_back(found->second);
+                            parents.at(found->second) = game;
+                        }
+                    }
+                }
+                for (int g = 0; g < roundGames.size(); g++) {
+                    lastGameWon[tournamentRecords.at(roundGames.at(g)).GetWinningTeam()] = roundGames.at(g);
+                }
+            }
+
+            // The championship is the game in the last round that did not send its winner anywhere
+            vector<int>& finalGames = getGamesInRound(lastRound);
+            for (int g = 0; g < finalGames.size() && championshipGame == -1; g++) {
+                if (parents.at(finalGames.at(g)) == -1) {
+                    championshipGame = finalGames.at(g);
+                }
+            }
+
+            // The main round is the first round with the whole field, which has the most games.
+            // Its games are labeled with the regions, in the order they are listed in the file.
+            for (int numRound = firstRound; numRound <= lastRound; numRound++) {
+                if (getGamesInRound(numRound).size() > getGamesInRound(mainRound).size()) {
+                    mainRound = numRound;
+                }
+            }
+            unordered_map<string, int> regionIndexByName;
+            vector<int>& mainGames = getGamesInRound(mainRound);
+            for (int g = 0; g < mainGames.size(); g++) {
+                string region = tournamentRecords.at(mainGames.at(g)).GetRegion();
+                if (regionIndexByName.find(region) == regionIndexByName.end()) {
+                    regionIndexByName[region] = regions.size();
+                    regions.push_back(region);
+                }
+            }
+
+            // Games with a region label are played within that region; the last round of them decides each region
+            for (int i = 0; i < numGames; i++) {
+                unordered_map<string, int>::iterator found = regionIndexByName.find(tournamentRecords.at(i).GetRegion());
+                if (found != regionIndexByName.end()) {
+                    regionIndexes.at(i) = found->second;
+                    lastRegionalRound = max(lastRegionalRound, tournamentRecords.at(i).GetNumRound());
+                }
+            }
+            regionalFinals.assign(regions.size(), -1);
+            vector<int>& regionalFinalGames = getGamesInRound(lastRegionalRound);
+            for (int g = 0; g < regionalFinalGames.size(); g++) {
+                int region = regionIndexes.at(regionalFinalGames.at(g));
+                if (region != -1 && regionalFinals.at(region) == -1) {
+                    regionalFinals.at(region) = regionalFinalGames.at(g);
+                }
+            }
+        }
+
+        int getChampionshipGame() { return championshipGame; }
+        int getFirstRound() { return firstRound; }
+        int getLastRound() { return lastRound; }
+        int getMainRound() { return mainRound; }
+        int getLastRegionalRound() { return lastRegionalRound; }
+
+        // Games of a round, in file order (empty for a round that is not in the tournament)
+        vector<int>& getGamesInRound(int numRound) {
+            if (numRound < firstRound || numRound > lastRound) {
+                return noGames;
+            }
+            return gamesInRound.at(numRound - firstRound);
+        }
+
+        // The game the winner of this game played next, or -1 for the championship
+        int getParent(int game) { return parents.at(game); }
+        // The games that sent the teams to this game
+        vector<int>& getSubBrackets(int game) { return subBrackets.at(game); }
+
+        vector<string>& getRegions() { return regions; }
+        // Position in getRegions() of the region a game was played in, or -1 for games between regions
+        int getRegionIndex(int game) { return regionIndexes.at(game); }
+        // The last game played within each region, in the same order as getRegions() (-1 if there is none)
+        vector<int>& getRegionalFinals() { return regionalFinals; }
+
+        // Name of a round based on the number of teams left in it, e.g. 'Sweet 16'
+        string getRoundName(int numRound) {
+            if (numRound < mainRound) {
+                return "Play-in";
+            }
+            int numTeams = 2 * getGamesInRound(numRound).size();
+            if (numTeams == 16) { return "Sweet 16"; }
+            if (numTeams == 8) { return "Elite 8"; }
+            if (numTeams == 4) { return "Final 4"; }
+            if (numTeams == 2) { return "Championship"; }
+            return "";
+        }
+
+    private:
+        vector<int> parents;
+        vector< vector<int> > subBrackets;
+        vector< vector<int> > gamesInRound;
+        vector<int> noGames;
+        vector<string> regions;
+        vector<int> regionIndexes;
+        vector<int> regionalFinals;
+        int championshipGame;
+        int firstRound, lastRound, mainRound, lastRegionalRound;
+};
+
+
+//--------------------------------------------------------------------------------
+// Prompt the user to select a round from firstChoice up to lastChoice, naming each round
+int promptForRound(BracketEngine& bracket, int firstChoice, int lastChoice) {
+
+    int inputRound;
+    cout << "Enter a round to be evaluated:\n";
+    for (int numRound = firstChoice; numRound <= lastChoice; numRound++) {
+        string roundName = bracket.getRoundName(numRound);
+        cout << "   Select " << numRound << " for round " << numRound
+             << (roundName.empty() ? "" : " '" + roundName + "'") << "\n";
+    }
+    cout << "Your choice --> ";
+    cin >> inputRound;
+    return inputRound;
+} // end promptForRound()
+
+
 // ----------------------------------------------------------------------
 // MENU OPTION 1 :: Display overall information about the data
-void overallTournamentStats(vector<TournamentRecord>& tournamentRecords) {
+void overallTournamentStats(vector<TournamentRecord>& tournamentRecords, BracketEngine& bracket) {
   
     // Number of games played in the tournament         
     cout << "Total number of games played in tournament: " << tournamentRecords.size() << endl;
 
-    // Final Four contestants with region
-    cout << "The Final Four contestants are:" << endl;
+    // Winner of each region (the Final Four contestants when there are 4 regions), in the order the regions are listed
+    if (bracket.getRegions().size() == 4) {
+        cout << "The Final Four contestants are:" << endl;
+    } else {
+        cout << "The winners of the " << bracket.getRegions().size() << " regions are:" << endl;
+    }
   
-    for (int i = 0; i < tournamentRecords.size(); i++) {
-        if (tournamentRecords.at(i).GetNumRound() == 4) {
-            cout << "        " << tournamentRecords.at(i).GetRegion() << " region:    " 
-                 << tournamentRecords.at(i).GetWinningTeam() << endl;
+    for (int region = 0; region < bracket.getRegions().size(); region++) {
+        int regionalFinal = bracket.getRegionalFinals().at(region);
+        if (regionalFinal != -1) {
+            cout << "        " << tournamentRecords.at(regionalFinal).GetRegion() << " region:    " 
+                 << tournamentRecords.at(regionalFinal).GetWinningTeam() << endl;
         }
     }
 } // end overallTournamentStats()
@@ -151,155 +944,169 @@ void overallTournamentStats(vector<TournamentRecord>& tournamentRecords) {
 
 // ----------------------------------------------------------------------
 // MENU OPTION 2 :: Display the winning team's path to championship
-void pathToChampionship(vector<TournamentRecord>& tournamentRecords) {
-
-    string championTeam = tournamentRecords.at(0).GetWinningTeam();
+void pathToChampionship(vector<TournamentRecord>& tournamentRecords, BracketEngine& bracket) {
+
+    int game = bracket.getChampionshipGame();
+    string championTeam = tournamentRecords.at(game).GetWinningTeam();
+
+    // follow the games this team won before the championship back down the bracket
+    vector<int> path;
+    while (game != -1) {
+        path.push_back(game);
+        int previousGame = -1;
+        vector<int>& subBrackets = bracket.getSubBrackets(game);
+        for (int i = 0; i < subBrackets.size(); i++) {
+            if (tournamentRecords.at(subBrackets.at(i)).GetWinningTeam() == championTeam) {
+                previousGame = subBrackets.at(i);
+            }
+        }
+        game = previousGame;
+    }
   
     cout << "Path to the championship:" << endl;
 
-    // iterate data backwards for games this team won before the championship
-    for (int i = tournamentRecords.size()-1; i >= 0; i--) {
-        if (tournamentRecords.at(i).GetWinningTeam() == championTeam) {
-            cout << "Round " << tournamentRecords.at(i).GetNumRound()
-                 << ", Game " << tournamentRecords.at(i).GetNumGame() << ": "
-                 << tournamentRecords.at(i).GetTeam1() << " vs "
-                 << tournamentRecords.at(i).GetTeam2() 
-                 << ". Winner: " << tournamentRecords.at(i).GetWinningTeam()
-                 << endl;
-        }
+    for (int i = path.size()-1; i >= 0; i--) {
+        cout << "Round " << tournamentRecords.at(path.at(i)).GetNumRound()
+             << ", Game " << tournamentRecords.at(path.at(i)).GetNumGame() << ": "
+             << tournamentRecords.at(path.at(i)).GetTeam1() << " vs "
+             << tournamentRecords.at(path.at(i)).GetTeam2() 
+             << ". Winner: " << tournamentRecords.at(path.at(i)).GetWinningTeam()
+             << endl;
     }
 } // end pathToChampionship()
 
 
-// ----------------------------------------------------------------------
-// MENU OPTION 3 :: Display region expected to win championship based on given round
-void expectedChampionRegion(vector<TournamentRecord>& tournamentRecords) {
+//--------------------------------------------------------------------------------
+// Whether the region expected to win can be predicted from a round: the rounds from the second round up to the
+// first round between regions (the Final Four)
+bool isRegionPredictionRound(BracketEngine& bracket, int numRound) {
+    return (numRound > bracket.getMainRound() && numRound <= bracket.getLastRegionalRound())
+        || (numRound == bracket.getLastRegionalRound() + 1 && !bracket.getGamesInRound(numRound).empty());
+} // end isRegionPredictionRound()
 
-    // Prompt user to select a round from 2-5
-    int inputRound;
-    cout << "Enter a round to be evaluated:\n"
-         << "   Select 2 for round 2\n"
-         << "   Select 3 for round 3 'Sweet 16'\n"
-         << "   Select 4 for round 4 'Elite 8'\n"
-         << "   Select 5 for round 5 'Final 4'\n"
-         << "Your choice --> ";
-    cin >> inputRound;
-    cout << "Analyzing round " << inputRound << "...\n\n";
 
-    // ROUNDS 2-4
-    // Create vector with the names of the regions in this file
-    vector <string> fourRegions;
-    for (int i = 3; i < tournamentRecords.size(); i++) {        // Start at 3 to skip the 3 games that are from the championship or final four
-        string region = tournamentRecords.at(i).GetRegion();
+//--------------------------------------------------------------------------------
+// Region expected to win the championship based on a given round, or "" if it cannot be worked out.
+// For the rounds within the regions, the region whose winners in that round have the lowest sum of ranks;
+// for the first round between regions, the region that sent the best ranking team to it.
+string predictRegionByRankSum(vector<TournamentRecord>& tournamentRecords, BracketEngine& bracket, int inputRound) {
 
-        // Add the region to the vector if it is not found in the vector already
-        if (find(fourRegions.begin(), fourRegions.end(), region) == fourRegions.end()) {
-            fourRegions.push_back(region);
-        }
-        // There are always 4 regions, so once we have all 4 we can break out of this loop
-        if(fourRegions.size() == 4) {
-            break;
-        }
-    }
+    vector<string>& regions = bracket.getRegions();
 
-    // Create vector (parallel to fourRegions) for sum of ranks of teams per region who won games in given round
-    vector <int> sumOfWinningRanksInRegion(4, 0);      // initialize 4 elements at 0
+    // ROUNDS WITHIN THE REGIONS (rounds 2-4)
+    // Vector (parallel to regions) for sum of ranks of teams per region who won games in given round
+    vector <int> sumOfWinningRanksInRegion(regions.size(), 0);
 
     // Determine which region is expected to win the championship
-    if (inputRound >= 2 && inputRound <= 4) {
-        for (int game = 0; game < tournamentRecords.size(); game++) {
-            // Check if game is in selected round
-            if (tournamentRecords.at(game).GetNumRound() == inputRound) {
-                for (int region = 0; region < fourRegions.size(); region++) {
-                    // Add to sum of ranks for respective region
-                    if (tournamentRecords.at(game).GetRegion() == fourRegions.at(region)) {
-                        // Add rank of winning team, 1 or 2
-                        if (tournamentRecords.at(game).GetWinningTeam() == tournamentRecords.at(game).GetTeam1()) {
-                            sumOfWinningRanksInRegion.at(region) += tournamentRecords.at(game).GetRank1();
-                        }
-                        else if (tournamentRecords.at(game).GetWinningTeam() == tournamentRecords.at(game).GetTeam2()) {
-                            sumOfWinningRanksInRegion.at(region) += tournamentRecords.at(game).GetRank2();
-                        }
-                    }
-                }
+    if (inputRound > bracket.getMainRound() && inputRound <= bracket.getLastRegionalRound()) {
+        vector<int>& roundGames = bracket.getGamesInRound(inputRound);
+        for (int i = 0; i < roundGames.size(); i++) {
+            int game = roundGames.at(i);
+            int region = bracket.getRegionIndex(game);
+            if (region == -1) {
+                continue;
+            }
+            // Add rank of winning team, 1 or 2, to sum of ranks for respective region
+            if (tournamentRecords.at(game).GetWinningTeam() == tournamentRecords.at(game).GetTeam1()) {
+                sumOfWinningRanksInRegion.at(region) += tournamentRecords.at(game).GetRank1();
+            }
+            else if (tournamentRecords.at(game).GetWinningTeam() == tournamentRecords.at(game).GetTeam2()) {
+                sumOfWinningRanksInRegion.at(region) += tournamentRecords.at(game).GetRank2();
             }
         }
 
         // Initialize with first element it will check (due to "less than" functionality)
-        string expectedWinningRegion = fourRegions.at(0);
+        string expectedWinningRegion = regions.at(0);
         int lowestSumOfRanks = sumOfWinningRanksInRegion.at(0);
 
         // Search for smallest sum and linked region
         for (int i = 0; i < sumOfWinningRanksInRegion.size(); i++) {
             if (sumOfWinningRanksInRegion.at(i) < lowestSumOfRanks) {
                 lowestSumOfRanks = sumOfWinningRanksInRegion.at(i);
-                expectedWinningRegion = fourRegions.at(i);
+                expectedWinningRegion = regions.at(i);
             }
         }
-      
-        cout << "The region expected to win is: " << expectedWinningRegion << endl;
+        return expectedWinningRegion;
     }
 
-    // ROUND 5
-    else if (inputRound == 5) {
-        // Initialize with first element it will check (due to "less than" functionality)
-        string bestRankingTeam = tournamentRecords.at(1).GetTeam1();
-        int bestRank = tournamentRecords.at(1).GetRank1();
+    // FIRST ROUND BETWEEN REGIONS (round 5, the Final Four)
+    else if (inputRound == bracket.getLastRegionalRound() + 1 && !bracket.getGamesInRound(inputRound).empty()) {
+        vector<int>& roundGames = bracket.getGamesInRound(inputRound);
 
-        // Search for best ranking team (between 1-16, 1 is best) in Final Four
-        for (int i = 1; i <= 2; i++) {
-            if (tournamentRecords.at(i).GetRank1() < bestRank) {
-                bestRank = tournamentRecords.at(i).GetRank1();
-                bestRankingTeam = tournamentRecords.at(i).GetTeam1();
+        // Initialize with first element it will check (due to "less than" functionality)
+        int bestRankingGame = roundGames.at(0);
+        string bestRankingTeam = tournamentRecords.at(bestRankingGame).GetTeam1();
+        int bestRank = tournamentRecords.at(bestRankingGame).GetRank1();
+
+        // Search for best ranking team (1 is best) in this round
+        for (int i = 0; i < roundGames.size(); i++) {
+            int game = roundGames.at(i);
+            if (tournamentRecords.at(game).GetRank1() < bestRank) {
+                bestRank = tournamentRecords.at(game).GetRank1();
+                bestRankingTeam = tournamentRecords.at(game).GetTeam1();
+                bestRankingGame = game;
             }
-            if (tournamentRecords.at(i).GetRank2() < bestRank) {
-                bestRank = tournamentRecords.at(i).GetRank2();
-                bestRankingTeam = tournamentRecords.at(i).GetTeam2();
+            if (tournamentRecords.at(game).GetRank2() < bestRank) {
+                bestRank = tournamentRecords.at(game).GetRank2();
+                bestRankingTeam = tournamentRecords.at(game).GetTeam2();
+                bestRankingGame = game;
             }
         }
 
-        // Search for the game (round 5-1=4) that sent bestRankingTeam to the finals
-        for (int i =0; i<tournamentRecords.size(); i++) {
-            if (tournamentRecords.at(i).GetNumRound() == 4 && tournamentRecords.at(i).GetWinningTeam() == bestRankingTeam) {
-                cout << "The region expected to win is: " << tournamentRecords.at(i).GetRegion() << endl;
+        // Search for the game that sent bestRankingTeam here from its region
+        vector<int>& subBrackets = bracket.getSubBrackets(bestRankingGame);
+        for (int i = 0; i < subBrackets.size(); i++) {
+            if (tournamentRecords.at(subBrackets.at(i)).GetWinningTeam() == bestRankingTeam) {
+                return tournamentRecords.at(subBrackets.at(i)).GetRegion();
             }
         }
     }
+    return "";
+} // end predictRegionByRankSum()
+
+
+// ----------------------------------------------------------------------
+// MENU OPTION 3 :: Display region expected to win championship based on given round
+void expectedChampionRegion(vector<TournamentRecord>& tournamentRecords, BracketEngine& bracket) {
+
+    // Prompt user to select a round from the second round up to the first round between regions (the Final Four)
+    int inputRound = promptForRound(bracket, bracket.getMainRound() + 1, bracket.getLastRegionalRound() + 1);
+    cout << "Analyzing round " << inputRound << "...\n\n";
+
+    if (!isRegionPredictionRound(bracket, inputRound)) {
+        cout << "Invalid round." << endl;
+        return;
+    }
+    string expectedWinningRegion = predictRegionByRankSum(tournamentRecords, bracket, inputRound);
+    if (!expectedWinningRegion.empty()) {
+        cout << "The region expected to win is: " << expectedWinningRegion << endl;
+    }
 } // end expectedChampionRegion()
 
 
 // ----------------------------------------------------------------------
 // MENU OPTION 4 :: Identify the best underdog within a given round
-void bestUnderdog(vector<TournamentRecord>& tournamentRecords) {
-
-    // Prompt user to select a round from 2-6
-    int inputRound;
+void bestUnderdog(vector<TournamentRecord>& tournamentRecords, BracketEngine& bracket) {
 
-    cout << "Enter a round to be evaluated:\n"
-         << "   Select 2 for round 2\n"
-         << "   Select 3 for round 3 'Sweet 16'\n"
-         << "   Select 4 for round 4 'Elite 8'\n"
-         << "   Select 5 for round 5 'Final 4'\n"
-         << "   Select 6 for round 6 'Championship'\n"
-         << "Your choice --> ";
-    cin >> inputRound;
+    // Prompt user to select a round from the second round up to the championship
+    int inputRound = promptForRound(bracket, bracket.getMainRound() + 1, bracket.getLastRound());
 
     // Search for the worst ranking team in the games for the selected round
     string bestUnderdogTeam;
     int bestUnderdogRank = 0;  // a higher rank number indicates that the team is worse so we can start at 0
 
-    for (int i = 0; i < tournamentRecords.size(); i++) {
+    vector<int>& roundGames = bracket.getGamesInRound(inputRound);
+    for (int i = 0; i < roundGames.size(); i++) {
+        int game = roundGames.at(i);
         // Search for lowest rank (highest number) in Teams 1 
-        if (tournamentRecords.at(i).GetNumRound() == inputRound
-          && tournamentRecords.at(i).GetRank1() > bestUnderdogRank) {
-            bestUnderdogRank = tournamentRecords.at(i).GetRank1();
-            bestUnderdogTeam = tournamentRecords.at(i).GetTeam1();
+        if (tournamentRecords.at(game).GetRank1() > bestUnderdogRank) {
+            bestUnderdogRank = tournamentRecords.at(game).GetRank1();
+            bestUnderdogTeam = tournamentRecords.at(game).GetTeam1();
         }
         // Search for lowest rank (highest number) in Teams 2
-        if (tournamentRecords.at(i).GetNumRound() == inputRound 
-          && tournamentRecords.at(i).GetRank2() > bestUnderdogRank) {
-            bestUnderdogRank = tournamentRecords.at(i).GetRank2();
-            bestUnderdogTeam = tournamentRecords.at(i).GetTeam2();
+        if (tournamentRecords.at(game).GetRank2() > bestUnderdogRank) {
+            bestUnderdogRank = tournamentRecords.at(game).GetRank2();
+            bestUnderdogTeam = tournamentRecords.at(game).GetTeam2();
         }
     }
 
@@ -309,36 +1116,46 @@ void bestUnderdog(vector<TournamentRecord>& tournamentRecords) {
 
 // ----------------------------------------------------------------------
 // MENU OPTION 5 :: Find the shoo-in and nail-biting games within a given round, or overall
-void specialGames(vector<TournamentRecord>& tournamentRecords) {
+void specialGames(vector<TournamentRecord>& tournamentRecords, BracketEngine& bracket) {
 
-    // Prompt user to select a round from 1-6, or 7 for all rounds
+    // Prompt user to select a round, or the round after the championship for all rounds
+    int overallChoice = bracket.getLastRound() + 1;
     int inputRound;
 
-    cout << "Enter a round to be evaluated:\n"
-         << "   Select 1 for round 1\n"
-         << "   Select 2 for round 2\n"
-         << "   Select 3 for round 3 'Sweet 16'\n"
-         << "   Select 4 for round 4 'Elite 8'\n"
-         << "   Select 5 for round 5 'Final 4'\n"
-         << "   Select 6 for round 6 'Championship'\n"
-         << "   Select 7 for the overall tournament\n"
+    cout << "Enter a round to be evaluated:\n";
+    for (int numRound = bracket.getFirstRound(); numRound <= bracket.getLastRound(); numRound++) {
+        string roundName = bracket.getRoundName(numRound);
+        cout << "   Select " << numRound << " for round " << numRound
+             << (roundName.empty() ? "" : " '" + roundName + "'") << "\n";
+    }
+    cout << "   Select " << overallChoice << " for the overall tournament\n"
          << "Your choice --> ";
     cin >> inputRound;
-    if (inputRound == 7) { cout << "Analyzing the overall tournament...\n\n"; } 
+    if (inputRound == overallChoice) { cout << "Analyzing the overall tournament...\n\n"; } 
     else { cout << "Analyzing round " << inputRound << "...\n\n"; }
 
+    // Skip games that are not in the selected round, if the user has selected a particular round
+    vector<int> allGames;
+    if (inputRound == overallChoice) {
+        for (int i = 0; i < tournamentRecords.size(); i++) {
+            allGames.push_back(i);
+        }
+    }
+    vector<int>& selectedGames = (inputRound == overallChoice) ? allGames : bracket.getGamesInRound(inputRound);
+    if (selectedGames.empty()) {
+        cout << "There are no games in that round.\n";
+        return;
+    }
+
     // Shoo-in game has greatest difference in scores
-    int greatestScoreDifference = 0;
+    int greatestScoreDifference = -1;
     int shooInIndex;
   
-    for (int i = 0; i < tournamentRecords.size(); i++) {
-        // Skip game if user has selected a particular round and if this game is not in that round, otherwise...
-        if ((inputRound != 7 && tournamentRecords.at(i).GetNumRound() == inputRound) || inputRound == 7) {
-            int scoreDifference = abs(tournamentRecords.at(i).GetScore1() - tournamentRecords.at(i).GetScore2());
-            if (scoreDifference > greatestScoreDifference) {
-                greatestScoreDifference = scoreDifference;
-                shooInIndex = i;      // to display game details
-            }
+    for (int i = 0; i < selectedGames.size(); i++) {
+        int scoreDifference = abs(tournamentRecords.at(selectedGames.at(i)).GetScore1() - tournamentRecords.at(selectedGames.at(i)).GetScore2());
+        if (scoreDifference > greatestScoreDifference) {
+            greatestScoreDifference = scoreDifference;
+            shooInIndex = selectedGames.at(i);      // to display game details
         }
     }
   
@@ -346,13 +1163,11 @@ void specialGames(vector<TournamentRecord>& tournamentRecords) {
     int smallestScoreDifference = 10000;      // random large number
     int nailBitingIndex;
   
-    for (int i = 0; i < tournamentRecords.size(); i++) {
-        if ((inputRound != 7 && tournamentRecords.at(i).GetNumRound() == inputRound) || inputRound == 7) {
-            int scoreDifference = abs(tournamentRecords.at(i).GetScore1() - tournamentRecords.at(i).GetScore2());
-            if (scoreDifference < smallestScoreDifference) {
-                smallestScoreDifference = scoreDifference;
-                nailBitingIndex = i;      // to display game details
-            }
+    for (int i = 0; i < selectedGames.size(); i++) {
+        int scoreDifference = abs(tournamentRecords.at(selectedGames.at(i)).GetScore1() - tournamentRecords.at(selectedGames.at(i)).GetScore2());
+        if (scoreDifference < smallestScoreDifference) {
+            smallestScoreDifference = scoreDifference;
+            nailBitingIndex = selectedGames.at(i);      // to display game details
         }
     }
   
@@ -384,7 +1199,14 @@ void compareBrackets(vector<TournamentRecord>& tournamentRecords) {
 
     // Read in the data from the file into a vector
     vector<TournamentRecord> tournamentPredictions;
-    readInTournamentData(fileName, tournamentPredictions);
+    vector<LoadError> errors;
+    bool opened = readInTournamentDataParallel(fileName, tournamentPredictions, errors, defaultNumThreads());
+
+    // The games are compared by position, so a file with missing games cannot be scored
+    if (displayLoadErrors(fileName, errors) || !opened || tournamentPredictions.size() != tournamentRecords.size()) {
+        cout << "Your predictions could not be compared, because they do not list the same games as the tournament.\n";
+        return;
+    }
 
     // Compare actual and predicted brackets by comparing the winning teams
     int userScore = 0;
@@ -409,19 +1231,1263 @@ void compareBrackets(vector<TournamentRecord>& tournamentRecords) {
 
 } // end compareBrackets()
 
+
+// Brackets in a pool that differ in at most this many games are grouped into the same cluster
+const int MAX_CLUSTER_DISTANCE = 6;
+
+// A pool of predicted brackets with the duplicates collapsed and similar brackets grouped together.
+// Each unique bracket is stored once as the winner of each game (as a team ID); a bracket in a cluster
+// also keeps the games where it differs from the cluster's leader, so it can be scored from the leader's score.
+struct BracketPool {
+    unordered_map<string, int> teamIds;
+    vector< vector<int> > uniqueBrackets;
+    vector<int> multiplicity;                     // how many entries have each unique bracket
+    vector<int> entryToUnique;                    // the unique bracket of each entry, in pool order
+    vector<int> uniqueToCluster;
+    vector<int> clusterLeaders;                   // the unique bracket that leads each cluster
+    vector< vector<int> > differencesFromLeader;  // for each unique bracket, the games where it differs from its leader
+    long gamesRead = 0;                           // games read or compared while building the pool
+};
+
+
+//--------------------------------------------------------------------------------
+// Look up the ID of a team, giving it the next ID if it has not been seen before
+int internTeam(BracketPool& pool, const string& team) {
+    unordered_map<string, int>::iterator found = pool.teamIds.find(team);
+    if (found != pool.teamIds.end()) {
+        return found->second;
+    }
+    int teamId = pool.teamIds.size();
+    pool.teamIds[team] = teamId;
+    return teamId;
+} // end internTeam()
+
+
+//--------------------------------------------------------------------------------
+// Split the records of a pool file into entries of gamesPerEntry games each, collapse entries that
+// predict the same winner for every game, and group the unique brackets into clusters by the number
+// of games they differ in (Hamming distance)
+void buildBracketPool(vector<TournamentRecord>& poolRecords, int gamesPerEntry, BracketPool& pool) {
+
+    // unique brackets with the same hash of their winners, to find duplicates
+    unordered_map<size_t, vector<int> > uniqueByHash;
+
+    vector<int> bracket(gamesPerEntry, -1);
+    for (int entryStart = 0; entryStart + gamesPerEntry <= poolRecords.size(); entryStart += gamesPerEntry) {
+        size_t hash = 14695981039346656037ULL;   // FNV-1a over the team IDs of the winners
+        for (int i = 0; i < gamesPerEntry; i++) {
+            // Most entries pick the same winner as the entry before them, which saves looking up the ID
+            string winner = poolRecords.at(entryStart + i).GetWinningTeam();
+            if (entryStart == 0 || winner != poolRecords.at(entryStart - gamesPerEntry + i).GetWinningTeam()) {
+                bracket.at(i) = internTeam(pool, winner);
+            }
+            hash = (hash ^ bracket.at(i)) * 1099511628211ULL;
+        }
+        pool.gamesRead += gamesPerEntry;
+
+        // Collapse exact duplicates
+        vector<int>& sameHash = uniqueByHash[hash];
+        int uniqueIndex = -1;
+        for (int j = 0; j < sameHash.size(); j++) {
+            pool.gamesRead += gamesPerEntry;
+            if (pool.uniqueBrackets.at(sameHash.at(j)) == bracket) {
+                uniqueIndex = sameHash.at(j);
+                break;
+            }
+        }
+        if (uniqueIndex == -1) {
+            uniqueIndex = pool.uniqueBrackets.size();
+            sameHash.push_back(uniqueIndex);
+            pool.uniqueBrackets.push_back(bracket);
+            pool.multiplicity.push_back(0);
+        }
+        pool.multiplicity.at(uniqueIndex)++;
+        pool.entryToUnique.push_back(uniqueIndex);
+    }
+
+    // Each unique bracket joins the first cluster whose leader is close enough, or leads a new cluster.
+    // The games are split into MAX_CLUSTER_DISTANCE + 1 bands; two brackets that differ in at most
+    // MAX_CLUSTER_DISTANCE games must agree on every game of at least one band, so only leaders that
+    // share a band with the bracket need to be compared.
+    const int numBands = MAX_CLUSTER_DISTANCE + 1;
+    auto bandHash = [&](vector<int>& bracket, int band) {
+        size_t hash = 14695981039346656037ULL ^ band;
+        for (int i = band * gamesPerEntry / numBands; i < (band + 1) * gamesPerEntry / numBands; i++) {
+            hash = (hash ^ bracket.at(i)) * 1099511628211ULL;
+        }
+        return hash;
+    };
+    vector< unordered_map<size_t, vector<int> > > leadersByBand(numBands);
+
+    for (int u = 0; u < pool.uniqueBrackets.size(); u++) {
+        vector<int>& bracket = pool.uniqueBrackets.at(u);
+        vector<int> differences;
+        int cluster = -1;
+
+        vector<int> candidates;
+        for (int band = 0; band < numBands; band++) {
+            unordered_map<size_t, vector<int> >::iterator found = leadersByBand.at(band).find(bandHash(bracket, band));
+            if (found != leadersByBand.at(band).end()) {
+                candidates.insert(candidates.end(), found->second.begin(), found->second.end());
+            }
+        }
+        sort(candidates.begin(), candidates.end());
+        candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+
+        for (int k = 0; k < candidates.size() && cluster == -1; k++) {
+            int c = candidates.at(k);
+            vector<int>& leader = pool.uniqueBrackets.at(pool.clusterLeaders.at(c));
+            differences.clear();
+            for (int i = 0; i < gamesPerEntry && differences.size() <= MAX_CLUSTER_DISTANCE; i++) {
+                if (bracket.at(i) != leader.at(i)) {
+                    differences.push_back(i);
+                }
+                pool.gamesRead++;
+            }
+            if (differences.size() <= MAX_CLUSTER_DISTANCE) {
+                cluster = c;
+            }
+        }
+        if (cluster == -1) {
+            cluster = pool.clusterLeaders.size();
+            pool.clusterLeaders.push_back(u);
+            differences.clear();
+            for (int band = 0; band < numBands; band++) {
+                leadersByBand.at(band)[bandHash(bracket, band)].push_back(cluster);
+            }
+        }
+        pool.uniqueToCluster.push_back(cluster);
+        pool.differencesFromLeader.push_back(differences);
+    }
+} // end buildBracketPool()
+
+
+//--------------------------------------------------------------------------------
+// Score every unique bracket in the pool against the tournament. Each cluster leader is scored game by game;
+// every other bracket starts from its leader's score and only rescores the games where it differs.
+// Returns the score of each unique bracket, and adds the number of games that were compared to gamesCompared.
+vector<int> scoreBracketPool(vector<TournamentRecord>& tournamentRecords, BracketPool& pool, long& gamesCompared) {
+
+    vector<int> actualWinners;
+    for (int i = 0; i < tournamentRecords.size(); i++) {
+        actualWinners.push_back(internTeam(pool, tournamentRecords.at(i).GetWinningTeam()));
+    }
+
+    // For each winner predicted correctly, the round number of the game is multiplied by 5
+    auto gameScore = [&](vector<int>& bracket, int i) {
+        return (bracket.at(i) == actualWinners.at(i)) ? tournamentRecords.at(i).GetNumRound() * 5 : 0;
+    };
+
+    vector<int> leaderScores(pool.clusterLeaders.size(), 0);
+    for (int c = 0; c < pool.clusterLeaders.size(); c++) {
+        vector<int>& leader = pool.uniqueBrackets.at(pool.clusterLeaders.at(c));
+        for (int i = 0; i < actualWinners.size(); i++) {
+            leaderScores.at(c) += gameScore(leader, i);
+        }
+        gamesCompared += actualWinners.size();
+    }
+
+    vector<int> uniqueScores(pool.uniqueBrackets.size());
+    for (int u = 0; u < pool.uniqueBrackets.size(); u++) {
+        int cluster = pool.uniqueToCluster.at(u);
+        vector<int>& leader = pool.uniqueBrackets.at(pool.clusterLeaders.at(cluster));
+        int score = leaderScores.at(cluster);
+        for (int d = 0; d < pool.differencesFromLeader.at(u).size(); d++) {
+            int i = pool.differencesFromLeader.at(u).at(d);
+            score += gameScore(pool.uniqueBrackets.at(u), i) - gameScore(leader, i);
+        }
+        gamesCompared += pool.differencesFromLeader.at(u).size();
+        uniqueScores.at(u) = score;
+    }
+    return uniqueScores;
+} // end scoreBracketPool()
+
+
+//--------------------------------------------------------------------------------
+// Display how much work collapsing duplicates and clustering saved compared to scoring every entry, counting
+// the games read while building the pool. The pool is built once and can then be scored numScorings times.
+void displayPoolReduction(BracketPool& pool, int gamesPerEntry, long gamesCompared, int numScorings) {
+
+    long naiveGamesCompared = (long) pool.entryToUnique.size() * gamesPerEntry * numScorings;
+    long totalGames = pool.gamesRead + gamesCompared;
+    double ratio = (double) naiveGamesCompared / max(totalGames, 1L);
+    cout << pool.entryToUnique.size() << " entries, " << pool.uniqueBrackets.size() << " unique brackets, "
+         << pool.clusterLeaders.size() << " clusters (at most " << MAX_CLUSTER_DISTANCE << " games apart).\n"
+         << "Read " << pool.gamesRead << " games to build the pool and compared " << gamesCompared << " games in "
+         << numScorings << " scoring(s), " << totalGames << " in all, instead of " << naiveGamesCompared << ": ";
+    if (ratio >= 1) {
+        cout << ratio << "x less work.\n";
+    } else {
+        cout << 1 / ratio << "x more work (the pool pays off when it is scored again).\n";
+    }
+} // end displayPoolReduction()
+
+
+//--------------------------------------------------------------------------------
+// Display the best entries in a scored pool, in pool order for the same score
+void displayBestEntries(BracketPool& pool, vector<int>& uniqueScores) {
+
+    vector<int> entries(pool.entryToUnique.size());
+    for (int entry = 0; entry < entries.size(); entry++) {
+        entries.at(entry) = entry;
+    }
+    stable_sort(entries.begin(), entries.end(), [&](int a, int b) {
+        return uniqueScores.at(pool.entryToUnique.at(a)) > uniqueScores.at(pool.entryToUnique.at(b));
+    });
+
+    cout << "The best entries in the pool are:\n";
+    for (int rank = 0; rank < entries.size() && rank < 10; rank++) {
+        int unique = pool.entryToUnique.at(entries.at(rank));
+        cout << "        Entry " << entries.at(rank) + 1 << ":    " << uniqueScores.at(unique)
+             << " (same bracket as " << pool.multiplicity.at(unique) - 1 << " other entries)\n";
+    }
+    cout << "\n";
+} // end displayBestEntries()
+
+
+// ----------------------------------------------------------------------
+// MENU OPTION 7 :: Score a pool of predicted brackets
+void scorePool(vector<TournamentRecord>& tournamentRecords) {
+    string fileName;
+
+    cout << "Enter the name of the pool file (prediction files one after another, with one header):\n";
+    cin >> fileName;
+
+    vector<TournamentRecord> poolRecords;
+    vector<LoadError> errors;
+    bool opened = readInTournamentDataParallel(fileName, poolRecords, errors, defaultNumThreads());
+
+    // The games are compared by position, so every entry must list the same games as the tournament
+    if (displayLoadErrors(fileName, errors) || !opened || poolRecords.empty()
+      || poolRecords.size() % tournamentRecords.size() != 0) {
+        cout << "The pool could not be scored, because its entries do not list the same games as the tournament.\n";
+        return;
+    }
+
+    BracketPool pool;
+    buildBracketPool(poolRecords, tournamentRecords.size(), pool);
+    vector<TournamentRecord>().swap(poolRecords);   // the pool keeps what it needs
+    long gamesCompared = 0;
+    vector<int> uniqueScores = scoreBracketPool(tournamentRecords, pool, gamesCompared);
+    displayBestEntries(pool, uniqueScores);
+    int numScorings = 1;
+    displayPoolReduction(pool, tournamentRecords.size(), gamesCompared, numScorings);
+
+    // What if a game had gone the other way? The pool is built once and rescored with each change.
+    vector<TournamentRecord> whatIfRecords = tournamentRecords;
+    while (true) {
+        int numRound = -1;
+        cout << "\nEnter the round number of a game to give to the other team (or -1 to stop): ";
+        cin >> numRound;
+        if (numRound == -1 || !cin) {
+            break;
+        }
+        string winningTeam;
+        cout << "Enter the winning team of the game: ";
+        cin.ignore();
+        getline(cin, winningTeam);
+
+        int game = -1;
+        for (int i = 0; i < whatIfRecords.size() && game == -1; i++) {
+            if (whatIfRecords.at(i).GetNumRound() == numRound && whatIfRecords.at(i).GetWinningTeam() == winningTeam) {
+                game = i;
+            }
+        }
+        if (game == -1) {
+            cout << "Sorry, no games matching that round number and winning team were found.\n";
+            continue;
+        }
+        TournamentRecord &oneRecord = whatIfRecords.at(game);
+        oneRecord.SetWinningTeam(winningTeam == oneRecord.GetTeam1() ? oneRecord.GetTeam2() : oneRecord.GetTeam1());
+        cout << "If " << oneRecord.GetWinningTeam() << " had won that game:\n";
+
+        uniqueScores = scoreBracketPool(whatIfRecords, pool, gamesCompared);
+        numScorings++;
+        displayBestEntries(pool, uniqueScores);
+        displayPoolReduction(pool, tournamentRecords.size(), gamesCompared, numScorings);
+    }
+} // end scorePool()
+
+
+// A way to predict the region that will win the championship from the results of one round, so that
+// different heuristics can be evaluated side by side. predict() returns "" if it cannot make a prediction.
+struct RegionPredictor {
+    string name;
+    function<string(vector<TournamentRecord>&, BracketEngine&, int)> predict;
+};
+
+// Accuracy of one predictor for one round over the seasons of an archive, with 95% bootstrap confidence intervals.
+// The change is the difference in accuracy from the first predictor, resampled together with it.
+struct PredictorAccuracy {
+    int numRound;
+    int numSeasons;           // seasons where both the prediction and the actual region are known
+    double accuracy, lowerBound, upperBound;
+    double change, changeLowerBound, changeUpperBound;
+};
+
+
+//--------------------------------------------------------------------------------
+// Split an archive of seasons listed one after another into seasons. A season ends where a game
+// (region, round and game number, combined by gameKey) comes up that the season already has. seasonStarts
+// gets the position of the first game of each season, followed by the number of games.
+void splitIntoSeasons(int numGames, function<long long(int)> gameKey, vector<int>& seasonStarts) {
+
+    unordered_set<long long> gamesInSeason;
+    seasonStarts.clear();
+    for (int i = 0; i < numGames; i++) {
+        long long key = gameKey(i);
+        if (seasonStarts.empty() || !gamesInSeason.insert(key).second) {
+            seasonStarts.push_back(i);
+            gamesInSeason.clear();
+            gamesInSeason.insert(key);
+        }
+    }
+    seasonStarts.push_back(numGames);
+} // end splitIntoSeasons()
+
+
+//--------------------------------------------------------------------------------
+// Split a packed archive into seasons
+void splitIntoSeasons(PackedArchive& archive, vector<int>& seasonStarts) {
+    splitIntoSeasons(archive.size(), [&](int i) {
+        PackedGame &game = archive.getGame(i);
+        return (long long) ((game.region << 16) | (game.numRound << 8) | game.numGame);
+    }, seasonStarts);
+} // end splitIntoSeasons()
+
+
+//--------------------------------------------------------------------------------
+// Split an archive kept as records into seasons
+void splitIntoSeasons(vector<TournamentRecord>& tournamentRecords, vector<int>& seasonStarts) {
+    unordered_map<string, long long> regionIds;
+    splitIntoSeasons(tournamentRecords.size(), [&](int i) {
+        TournamentRecord &oneRecord = tournamentRecords.at(i);
+        long long region = regionIds.emplace(oneRecord.GetRegion(), regionIds.size()).first->second;
+        return (region << 40) | ((long long) oneRecord.GetNumRound() << 32) | oneRecord.GetNumGame();
+    }, seasonStarts);
+} // end splitIntoSeasons()
+
+
+//--------------------------------------------------------------------------------
+// Region of a team in a game: the region of the game, or for a game between regions, the region of the game
+// that sent the team to it. Returns -1 if there is none.
+int teamRegionIndex(vector<TournamentRecord>& tournamentRecords, BracketEngine& bracket, int game, string team) {
+
+    while (game != -1 && bracket.getRegionIndex(game) == -1) {
+        int previousGame = -1;
+        vector<int>& subBrackets = bracket.getSubBrackets(game);
+        for (int i = 0; i < subBrackets.size(); i++) {
+            if (tournamentRecords.at(subBrackets.at(i)).GetWinningTeam() == team) {
+                previousGame = subBrackets.at(i);
+            }
+        }
+        game = previousGame;
+    }
+    return (game == -1) ? -1 : bracket.getRegionIndex(game);
+} // end teamRegionIndex()
+
+
+//--------------------------------------------------------------------------------
+// Alternative predictor: the region of the best ranking team that won a game in the round (the first in the file if tied)
+string predictRegionByBestWinner(vector<TournamentRecord>& tournamentRecords, BracketEngine& bracket, int inputRound) {
+
+    vector<int>& roundGames = bracket.getGamesInRound(inputRound);
+    int bestRank = 0, bestRegion = -1;
+    for (int i = 0; i < roundGames.size(); i++) {
+        TournamentRecord &oneRecord = tournamentRecords.at(roundGames.at(i));
+        int rank = (oneRecord.GetWinningTeam() == oneRecord.GetTeam1()) ? oneRecord.GetRank1() : oneRecord.GetRank2();
+        int region = teamRegionIndex(tournamentRecords, bracket, roundGames.at(i), oneRecord.GetWinningTeam());
+        if (region != -1 && (bestRegion == -1 || rank < bestRank)) {
+            bestRank = rank;
+            bestRegion = region;
+        }
+    }
+    return (bestRegion == -1) ? "" : bracket.getRegions().at(bestRegion);
+} // end predictRegionByBestWinner()
+
+
+//--------------------------------------------------------------------------------
+// Alternative predictor: the region where the better ranking team won the most games in the round
+// (ties go to the first region)
+string predictRegionByFewestUpsets(vector<TournamentRecord>& tournamentRecords, BracketEngine& bracket, int inputRound) {
+
+    vector<string>& regions = bracket.getRegions();
+    vector<int> favoriteWins(regions.size(), 0);
+    vector<int>& roundGames = bracket.getGamesInRound(inputRound);
+    for (int i = 0; i < roundGames.size(); i++) {
+        TournamentRecord &oneRecord = tournamentRecords.at(roundGames.at(i));
+        bool team1Won = (oneRecord.GetWinningTeam() == oneRecord.GetTeam1());
+        int winnerRank = team1Won ? oneRecord.GetRank1() : oneRecord.GetRank2();
+        int loserRank = team1Won ? oneRecord.GetRank2() : oneRecord.GetRank1();
+        int region = teamRegionIndex(tournamentRecords, bracket, roundGames.at(i), oneRecord.GetWinningTeam());
+        if (region != -1 && winnerRank <= loserRank) {
+            favoriteWins.at(region)++;
+        }
+    }
+    if (regions.empty()) {
+        return "";
+    }
+    return regions.at(max_element(favoriteWins.begin(), favoriteWins.end()) - favoriteWins.begin());
+} // end predictRegionByFewestUpsets()
+
+
+//--------------------------------------------------------------------------------
+// The predictors that are evaluated, starting with the one the menu uses (the others are compared to it)
+vector<RegionPredictor> regionPredictors() {
+    return {
+        {"Rank sum (menu option 3)", predictRegionByRankSum},
+        {"Best ranking winner", predictRegionByBestWinner},
+        {"Fewest upsets", predictRegionByFewestUpsets},
+        {"First region listed", [](vector<TournamentRecord>&, BracketEngine& bracket, int) {
+            return bracket.getRegions().empty() ? string("") : bracket.getRegions().at(0);
+        }}
+    };
+} // end regionPredictors()
+
+
+//--------------------------------------------------------------------------------
+// Run every predictor for every round on every season, compare the predictions to the region of the actual champion,
+// and work out the accuracy with bootstrap confidence intervals: the seasons are resampled with replacement
+// numResamples times, and the 2.5th and 97.5th percentiles of the accuracy are taken. Both steps are spread across
+// threads. Each resample has its own random numbers, so the results do not depend on the number of threads.
+// loadSeason gives the records of one season, e.g. by unpacking only the season a thread is working on.
+// The result is indexed [predictor][round], for the rounds that at least one season has a prediction for.
+vector< vector<PredictorAccuracy> > evaluateRegionPredictors(int numSeasons, function<void(int, vector<TournamentRecord>&)> loadSeason,
+    vector<RegionPredictor>& predictors, int numResamples, int numThreads) {
+
+    int numPredictors = predictors.size();
+
+    // outcomes[season][predictor][round] is 1 for a correct prediction, 0 for a wrong one and -1 if there is none
+    vector< vector< vector<int> > > outcomes(numSeasons, vector< vector<int> >(numPredictors, vector<int>(MAX_ROUND + 2, -1)));
+
+    auto runThreads = [&](function<void()> worker) {
+        vector<thread> threads;
+        for (int t = 1; t < numThreads; t++) {
+            threads.push_back(thread(worker));
+        }
+        worker(); // the calling thread does its share too
+        for (int t = 0; t < threads.size(); t++) {
+            threads.at(t).join();
+        }
+    };
+
+    // Each thread takes the next season until there are none left
+    atomic<int> nextSeason(0);
+    runThreads([&]() {
+        vector<TournamentRecord> tournamentRecords;
+        int season;
+        while ((season = nextSeason++) < numSeasons) {
+            loadSeason(season, tournamentRecords);
+            BracketEngine bracket(tournamentRecords);
+            int champion = bracket.getChampionshipGame();
+            if (champion == -1) {
+                continue;
+            }
+            int actualRegion = teamRegionIndex(tournamentRecords, bracket, champion, tournamentRecords.at(champion).GetWinningTeam());
+            if (actualRegion == -1) {
+                continue;
+            }
+            for (int numRound = bracket.getMainRound() + 1; numRound <= bracket.getLastRegionalRound() + 1 && numRound <= MAX_ROUND + 1; numRound++) {
+                if (!isRegionPredictionRound(bracket, numRound)) {
+                    continue;
+                }
+                for (int p = 0; p < numPredictors; p++) {
+                    string predicted = predictors.at(p).predict(tournamentRecords, bracket, numRound);
+                    if (!predicted.empty()) {
+                        outcomes.at(season).at(p).at(numRound) = (predicted == bracket.getRegions().at(actualRegion)) ? 1 : 0;
+                    }
+                }
+            }
+        }
+    });
+
+    // The rounds that at least one season has a prediction for
+    vector<int> rounds;
+    for (int numRound = 0; numRound <= MAX_ROUND + 1; numRound++) {
+        bool anyPrediction = false;
+        for (int season = 0; season < numSeasons; season++) {
+            anyPrediction = anyPrediction || (outcomes.at(season).at(0).at(numRound) != -1);
+        }
+        if (anyPrediction) {
+            rounds.push_back(numRound);
+        }
+    }
+    int numRounds = rounds.size();
+
+    // Accuracy of each predictor and round in a sample of seasons (given as how many times each season was drawn),
+    // counting only the seasons where the first predictor and this one both made a prediction
+    auto accuracyOf = [&](vector<int>& timesDrawn, vector< vector<double> >& accuracy, vector<int>& counted) {
+        accuracy.assign(numPredictors, vector<double>(numRounds, 0));
+        for (int r = 0; r < numRounds; r++) {
+            for (int p = 0; p < numPredictors; p++) {
+                int numCorrect = 0, numCounted = 0;
+                for (int season = 0; season < numSeasons; season++) {
+                    int outcome = outcomes.at(season).at(p).at(rounds.at(r));
+                    if (timesDrawn.at(season) > 0 && outcome != -1 && outcomes.at(season).at(0).at(rounds.at(r)) != -1) {
+                        numCorrect += outcome * timesDrawn.at(season);
+                        numCounted += timesDrawn.at(season);
+                    }
+                }
+                accuracy.at(p).at(r) = (numCounted > 0) ? (double) numCorrect / numCounted : 0;
+                if (p == 0) {
+                    counted.at(r) = numCounted;
+                }
+            }
+        }
+    };
+
+    vector<int> allSeasons(numSeasons, 1);
+    vector< vector<double> > sampleAccuracy;
+    vector<int> seasonsCounted(numRounds, 0);
+    accuracyOf(allSeasons, sampleAccuracy, seasonsCounted);
+
+    // resampleAccuracy[predictor][round][resample]; each resample is filled in by exactly one thread
+    vector< vector< vector<double> > > resampleAccuracy(numPredictors, vector< vector<double> >(numRounds, vector<double>(numResamples)));
+    atomic<int> nextResample(0);
+    runThreads([&]() {
+        vector<int> timesDrawn(numSeasons);
+        vector< vector<double> > accuracy;
+        vector<int> counted(numRounds);
+        int resample;
+        while ((resample = nextResample++) < numResamples) {
+            mt19937 generator(2022 + resample);
+            uniform_int_distribution<int> seasonDistribution(0, numSeasons - 1);
+            fill(timesDrawn.begin(), timesDrawn.end(), 0);
+            for (int draw = 0; draw < numSeasons; draw++) {
+                timesDrawn.at(seasonDistribution(generator))++;
+            }
+            accuracyOf(timesDrawn, accuracy, counted);
+            for (int p = 0; p < numPredictors; p++) {
+                for (int r = 0; r < numRounds; r++) {
+                    resampleAccuracy.at(p).at(r).at(resample) = accuracy.at(p).at(r);
+                }
+            }
+        }
+    });
+
+    // The middle 95% of the resampled values
+    auto confidenceInterval = [&](vector<double> values, double& lowerBound, double& upperBound) {
+        sort(values.begin(), values.end());
+        lowerBound = values.at((int) (0.025 * (values.size() - 1)));
+        upperBound = values.at((int) (0.975 * (values.size() - 1) + 0.5));
+    };
+
+    vector< vector<PredictorAccuracy> > results(numPredictors, vector<PredictorAccuracy>(numRounds));
+    for (int p = 0; p < numPredictors; p++) {
+        for (int r = 0; r < numRounds; r++) {
+            PredictorAccuracy &cell = results.at(p).at(r);
+            cell.numRound = rounds.at(r);
+            cell.numSeasons = seasonsCounted.at(r);
+            cell.accuracy = sampleAccuracy.at(p).at(r);
+            cell.change = sampleAccuracy.at(p).at(r) - sampleAccuracy.at(0).at(r);
+            cell.lowerBound = cell.upperBound = cell.changeLowerBound = cell.changeUpperBound = 0;
+            if (numResamples > 0) {
+                confidenceInterval(resampleAccuracy.at(p).at(r), cell.lowerBound, cell.upperBound);
+                vector<double> changes(numResamples);
+                for (int resample = 0; resample < numResamples; resample++) {
+                    changes.at(resample) = resampleAccuracy.at(p).at(r).at(resample) - resampleAccuracy.at(0).at(r).at(resample);
+                }
+                confidenceInterval(changes, cell.changeLowerBound, cell.changeUpperBound);
+            }
+        }
+    }
+    return results;
+} // end evaluateRegionPredictors()
+
+
+//--------------------------------------------------------------------------------
+// Display the accuracy of each predictor for each round, as percentages
+void displayPredictorAccuracy(vector<RegionPredictor>& predictors, vector< vector<PredictorAccuracy> >& results) {
+
+    ostringstream out;
+    out.setf(ios::fixed);
+    out.precision(1);
+    for (int r = 0; r < (results.empty() ? 0 : results.at(0).size()); r++) {
+        out << "\nPredicting from round " << results.at(0).at(r).numRound << " (" << results.at(0).at(r).numSeasons << " seasons):\n";
+        for (int p = 0; p < predictors.size(); p++) {
+            PredictorAccuracy &cell = results.at(p).at(r);
+            out << "   " << predictors.at(p).name << ": " << 100 * cell.accuracy << "% correct (95% CI "
+                << 100 * cell.lowerBound << "% to " << 100 * cell.upperBound << "%)";
+            if (p > 0) {
+                out << ", " << (cell.change >= 0 ? "+" : "") << 100 * cell.change << " points vs " << predictors.at(0).name
+                    << " (95% CI " << 100 * cell.changeLowerBound << " to " << 100 * cell.changeUpperBound << ")";
+            }
+            out << "\n";
+        }
+    }
+    cout << out.str();
+} // end displayPredictorAccuracy()
+
+
+// ----------------------------------------------------------------------
+// MENU OPTION 9 :: Check how often the region expected to win actually won, over an archive of seasons
+void evaluateExpectedRegion() {
+    string fileName;
+
+    cout << "Enter the name of the archive file (seasons one after another, with one header):\n";
+    cin >> fileName;
+
+    // Keep the archive packed if it fits, and as records if it does not
+    PackedArchive archive;
+    vector<TournamentRecord> archiveRecords;
+    vector<LoadError> errors;
+    bool packed;
+    bool opened = readInPackedArchive(fileName, archive, errors, defaultNumThreads(), packed);
+    if (opened && !packed) {
+        cout << "The archive has numbers or names too large to pack, so it is kept as records.\n";
+        readInTournamentDataParallel(fileName, archiveRecords, errors, defaultNumThreads());
+    }
+    if (displayLoadErrors(fileName, errors) || !opened || (archive.size() == 0 && archiveRecords.empty())) {
+        cout << "The archive could not be evaluated.\n";
+        return;
+    }
+
+    vector<int> seasonStarts;
+    function<void(int, vector<TournamentRecord>&)> loadSeason;
+    if (packed) {
+        splitIntoSeasons(archive, seasonStarts);
+        loadSeason = [&](int season, vector<TournamentRecord>& tournamentRecords) {
+            archive.unpack(seasonStarts.at(season), seasonStarts.at(season + 1), tournamentRecords);
+        };
+    } else {
+        splitIntoSeasons(archiveRecords, seasonStarts);
+        loadSeason = [&](int season, vector<TournamentRecord>& tournamentRecords) {
+            tournamentRecords.assign(archiveRecords.begin() + seasonStarts.at(season), archiveRecords.begin() + seasonStarts.at(season + 1));
+        };
+    }
+    int numSeasons = seasonStarts.size() - 1;
+    cout << "Evaluating " << numSeasons << " seasons with 10000 bootstrap resamples...\n";
+
+    vector<RegionPredictor> predictors = regionPredictors();
+    vector< vector<PredictorAccuracy> > results = evaluateRegionPredictors(numSeasons, loadSeason, predictors, 10000, defaultNumThreads());
+    displayPredictorAccuracy(predictors, results);
+} // end evaluateExpectedRegion()
+
+
+//--------------------------------------------------------------------------------
+// Write an archive of the tournament data repeated for a number of seasons, for the benchmarks
+void writeSyntheticArchive(string filename, vector<TournamentRecord>& tournamentRecords, int numSeasons) {
+
+    ofstream outStream;
+    outStream.open(filename);
+    assert(outStream.fail() == false);
+
+    outStream << "region,rank1,team1,score1,rank2,team2,score2,winning-team,round-number,game-number\n";
+    for (int season = 0; season < numSeasons; season++) {
+        for (int i = 0; i < tournamentRecords.size(); i++) {
+            TournamentRecord &oneRecord = tournamentRecords.at(i);
+            outStream << oneRecord.GetRegion() << ',' << oneRecord.GetRank1() << ',' << oneRecord.GetTeam1() << ','
+                      << oneRecord.GetScore1() << ',' << oneRecord.GetRank2() << ',' << oneRecord.GetTeam2() << ','
+                      << oneRecord.GetScore2() << ',' << oneRecord.GetWinningTeam() << ','
+                      << oneRecord.GetNumRound() << ',' << oneRecord.GetNumGame() << '\n';
+        }
+    }
+} // end writeSyntheticArchive()
+
+
+//--------------------------------------------------------------------------------
+// Time reading in a multi-megabyte archive with getline() and with 1 thread up to one thread per core
+void benchmarkParallelLoading(vector<TournamentRecord>& tournamentRecords) {
+
+    const int numSeasons = 5000;
+    string archiveName = "benchmark_archive.csv";
+    writeSyntheticArchive(archiveName, tournamentRecords, numSeasons);
+
+    ifstream archiveStream(archiveName, ios::binary | ios::ate);
+    double archiveMB = archiveStream.tellg() / 1e6;
+    archiveStream.close();
+    cout << "Reading in " << numSeasons << " seasons (" << archiveMB << " MB)...\n\n";
+
+    auto start = chrono::steady_clock::now();
+    vector<TournamentRecord> serialRecords;
+    readInTournamentData(archiveName, serialRecords);
+    double serialSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "getline():     " << serialSeconds * 1000 << " ms, " << archiveMB / serialSeconds << " MB/s\n";
+
+    // 1, 2, 4, ... threads, always ending with one thread per core
+    int maxThreads = defaultNumThreads();
+    vector<int> threadCounts;
+    for (int numThreads = 1; numThreads < maxThreads; numThreads *= 2) {
+        threadCounts.push_back(numThreads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double oneThreadSeconds = 0;
+    for (int t = 0; t < threadCounts.size(); t++) {
+        int numThreads = threadCounts.at(t);
+        start = chrono::steady_clock::now();
+        vector<TournamentRecord> parallelRecords;
+        vector<LoadError> errors;
+        readInTournamentDataParallel(archiveName, parallelRecords, errors, numThreads);
+        double elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (numThreads == 1) {
+            oneThreadSeconds = elapsedSeconds;
+        }
+
+        // Check that the records came out in the same order as getline() reads them
+        bool sameOrder = (parallelRecords.size() == serialRecords.size());
+        for (int i = 0; sameOrder && i < parallelRecords.size(); i++) {
+            sameOrder = (parallelRecords.at(i).GetWinningTeam() == serialRecords.at(i).GetWinningTeam()
+                      && parallelRecords.at(i).GetNumGame() == serialRecords.at(i).GetNumGame());
+        }
+
+        cout << numThreads << " thread(s):   " << elapsedSeconds * 1000 << " ms, " << archiveMB / elapsedSeconds << " MB/s, "
+             << oneThreadSeconds / elapsedSeconds << "x" << (sameOrder ? "" : "  (RECORDS DO NOT MATCH)") << "\n";
+    }
+
+    remove(archiveName.c_str());
+} // end benchmarkParallelLoading()
+
+
+//--------------------------------------------------------------------------------
+// Time reading in a multi-megabyte archive with and without checking each line and the bracket
+void benchmarkValidation(vector<TournamentRecord>& tournamentRecords) {
+
+    const int numSeasons = 5000;
+    const int numRepetitions = 3;
+    string archiveName = "benchmark_archive.csv";
+    writeSyntheticArchive(archiveName, tournamentRecords, numSeasons);
+    cout << "Reading in " << numSeasons << " seasons with " << defaultNumThreads() << " thread(s)...\n\n";
+
+    double bestSeconds[2] = {1e9, 1e9};
+    for (int rep = 0; rep < numRepetitions; rep++) {
+        for (int validate = 0; validate <= 1; validate++) {
+            vector<TournamentRecord> records;
+            vector<LoadError> errors;
+            auto start = chrono::steady_clock::now();
+            readInTournamentDataParallel(archiveName, records, errors, defaultNumThreads(), validate == 1);
+            bestSeconds[validate] = min(bestSeconds[validate], chrono::duration<double>(chrono::steady_clock::now() - start).count());
+        }
+    }
+
+    cout << "Without checks: " << bestSeconds[0] * 1000 << " ms\n"
+         << "With checks:    " << bestSeconds[1] * 1000 << " ms\n"
+         << "The checks cost " << (bestSeconds[1] / bestSeconds[0] - 1) * 100 << "% extra.\n";
+
+    remove(archiveName.c_str());
+} // end benchmarkValidation()
+
+
+//--------------------------------------------------------------------------------
+// Build a realistic pool: most people pick one of a few hundred popular brackets, and some change a few games
+void generateSyntheticPool(vector<TournamentRecord>& tournamentRecords, int numEntries, vector<TournamentRecord>& poolRecords) {
+
+    const int numPopularBrackets = 300;
+    mt19937 generator(2022);
+    uniform_int_distribution<int> gameDistribution(0, tournamentRecords.size() - 1);
+
+    // Pick the other team to win a game
+    auto flipGame = [](TournamentRecord& oneRecord) {
+        oneRecord.SetWinningTeam(oneRecord.GetWinningTeam() == oneRecord.GetTeam1() ? oneRecord.GetTeam2() : oneRecord.GetTeam1());
+    };
+
+    vector< vector<TournamentRecord> > popularBrackets(numPopularBrackets, tournamentRecords);
+    for (int b = 0; b < numPopularBrackets; b++) {
+        for (int flip = 0; flip < 12; flip++) {
+            flipGame(popularBrackets.at(b).at(gameDistribution(generator)));
+        }
+    }
+
+    // The first popular brackets are picked far more often than the rest
+    vector<double> weights;
+    for (int b = 0; b < numPopularBrackets; b++) {
+        weights.push_back(1.0 / (b + 1));
+    }
+    discrete_distribution<int> bracketDistribution(weights.begin(), weights.end());
+    uniform_int_distribution<int> numFlipsDistribution(-4, 3);   // about half the entries change nothing
+
+    poolRecords.clear();
+    poolRecords.reserve((size_t) numEntries * tournamentRecords.size());
+    for (int entry = 0; entry < numEntries; entry++) {
+        vector<TournamentRecord> bracket = popularBrackets.at(bracketDistribution(generator));
+        for (int flip = numFlipsDistribution(generator); flip > 0; flip--) {
+            flipGame(bracket.at(gameDistribution(generator)));
+        }
+        poolRecords.insert(poolRecords.end(), bracket.begin(), bracket.end());
+    }
+} // end generateSyntheticPool()
+
+
+//--------------------------------------------------------------------------------
+// Time scoring a large pool against several simulated tournaments, entry by entry and with duplicates collapsed
+// and similar brackets clustered. The pool is built once, so the times include building it.
+void benchmarkPoolScoring(vector<TournamentRecord>& tournamentRecords) {
+
+    const int numEntries = 100000;
+    const int numSimulations = 10;
+    vector<TournamentRecord> poolRecords;
+    generateSyntheticPool(tournamentRecords, numEntries, poolRecords);
+
+    // The actual tournament, then simulations where a few games went the other way
+    mt19937 generator(2023);
+    uniform_int_distribution<int> gameDistribution(0, tournamentRecords.size() - 1);
+    vector< vector<TournamentRecord> > simulations(numSimulations, tournamentRecords);
+    for (int sim = 1; sim < numSimulations; sim++) {
+        for (int flip = 0; flip < 8; flip++) {
+            TournamentRecord &oneRecord = simulations.at(sim).at(gameDistribution(generator));
+            oneRecord.SetWinningTeam(oneRecord.GetWinningTeam() == oneRecord.GetTeam1() ? oneRecord.GetTeam2() : oneRecord.GetTeam1());
+        }
+    }
+    cout << "Scoring a pool of " << numEntries << " entries against " << numSimulations << " simulated tournaments...\n\n";
+
+    // Every entry on its own, the way compareBrackets() does
+    auto start = chrono::steady_clock::now();
+    vector< vector<int> > entryScores(numSimulations, vector<int>(numEntries, 0));
+    for (int sim = 0; sim < numSimulations; sim++) {
+        vector<TournamentRecord> &simulation = simulations.at(sim);
+        for (int entry = 0; entry < numEntries; entry++) {
+            for (int i = 0; i < simulation.size(); i++) {
+                if (simulation.at(i).GetWinningTeam() == poolRecords.at(entry * simulation.size() + i).GetWinningTeam()) {
+                    entryScores.at(sim).at(entry) += simulation.at(i).GetNumRound() * 5;
+                }
+            }
+        }
+    }
+    double naiveSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    BracketPool pool;
+    buildBracketPool(poolRecords, tournamentRecords.size(), pool);
+    double buildSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    long gamesCompared = 0;
+    bool sameScores = true;
+    for (int sim = 0; sim < numSimulations; sim++) {
+        vector<int> uniqueScores = scoreBracketPool(simulations.at(sim), pool, gamesCompared);
+        for (int entry = 0; entry < numEntries; entry++) {
+            sameScores = sameScores && (uniqueScores.at(pool.entryToUnique.at(entry)) == entryScores.at(sim).at(entry));
+        }
+    }
+    double scoreSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // The pool pays for itself once the time it saves on each scoring covers the time to build it
+    double naivePerScoring = naiveSeconds / numSimulations;
+    double poolPerScoring = scoreSeconds / numSimulations;
+    double totalSeconds = buildSeconds + scoreSeconds;
+    cout << "Entry by entry:         " << naivePerScoring * 1000 << " ms per scoring, " << naiveSeconds * 1000 << " ms in all\n"
+         << "Collapsing/clustering:  " << buildSeconds * 1000 << " ms to build the pool once, then "
+         << poolPerScoring * 1000 << " ms per scoring, " << totalSeconds * 1000 << " ms in all"
+         << (sameScores ? "" : "  (SCORES DO NOT MATCH)") << "\n"
+         << "End to end:             " << naiveSeconds / totalSeconds << "x faster for " << numSimulations << " scorings; "
+         << "the pool pays for itself after " << (int) ceil(buildSeconds / max(naivePerScoring - poolPerScoring, 1e-9))
+         << " scoring(s)\n\n";
+    displayPoolReduction(pool, tournamentRecords.size(), gamesCompared, numSimulations);
+} // end benchmarkPoolScoring()
+
+
+//--------------------------------------------------------------------------------
+// Build a synthetic bracket of 2^numRounds teams in 4 regions (or numRegions, a power of 2), plus 4 play-in
+// games in round 0 like the First Four. The better ranked team wins most games; the seed picks which upsets
+// happen. Games are listed the same way as the files: championship first, then the games between regions,
+// then the games of each region by round.
+void generateSyntheticBracket(int numRounds, vector<TournamentRecord>& tournamentRecords, unsigned seed = 2022, int numRegions = 4) {
+
+    vector<string> regionNames = {"East", "West", "South", "Midwest"};
+    if (numRegions != 4) {
+        regionNames.clear();
+        for (int region = 0; region < numRegions; region++) {
+            regionNames.push_back("Region " + to_string(region + 1));
+        }
+    }
+    mt19937 generator(seed);
+    uniform_real_distribution<double> upsetDistribution(0.0, 1.0);
+
+    struct Team { string name; int rank; };
+    vector<TournamentRecord> gamesByRound[64];
+
+    // Play a round between neighbouring teams and return the winners
+    auto playRound = [&](vector<Team>& teams, int numRound, string region, int firstGameNum) {
+        vector<Team> winners;
+        for (int i = 0; i + 1 < teams.size(); i += 2) {
+            TournamentRecord oneRecord;
+            oneRecord.SetRegion(region);
+            oneRecord.SetRank1(teams.at(i).rank);
+            oneRecord.SetTeam1(teams.at(i).name);
+            oneRecord.SetScore1(60 + generator() % 30);
+            oneRecord.SetRank2(teams.at(i + 1).rank);
+            oneRecord.SetTeam2(teams.at(i + 1).name);
+            oneRecord.SetScore2(60 + generator() % 30);
+            bool team1Wins = (teams.at(i).rank <= teams.at(i + 1).rank) == (upsetDistribution(generator) < 0.75);
+            Team winner = team1Wins ? teams.at(i) : teams.at(i + 1);
+            oneRecord.SetWinningTeam(winner.name);
+            oneRecord.SetNumRound(numRound);
+            oneRecord.SetNumGame(firstGameNum + i / 2);
+            gamesByRound[numRound].push_back(oneRecord);
+            winners.push_back(winner);
+        }
+        return winners;
+    };
+
+    // Each region starts with its share of the field, ranked 1 up to the size of the region.
+    // The last 4 spots of the first region are filled by the winners of the play-in games.
+    int teamsPerRegion = (1 << numRounds) / numRegions;
+    vector< vector<Team> > regionTeams(numRegions);
+    for (int region = 0; region < numRegions; region++) {
+        for (int spot = 0; spot < teamsPerRegion; spot++) {
+            Team oneTeam = {regionNames[region] + " Team " + to_string(spot + 1), spot + 1};
+            regionTeams.at(region).push_back(oneTeam);
+        }
+    }
+    vector<Team> playInTeams;
+    for (int spot = teamsPerRegion - 4; spot < teamsPerRegion; spot++) {
+        for (int side = 0; side < 2; side++) {
+            Team oneTeam = {"Play-in Team " + to_string(spot + 1) + (side == 0 ? "a" : "b"), spot + 1};
+            playInTeams.push_back(oneTeam);
+        }
+    }
+    vector<Team> playInWinners = playRound(playInTeams, 0, regionNames[0], 1);
+    for (int i = 0; i < 4; i++) {
+        regionTeams.at(0).at(teamsPerRegion - 4 + i) = playInWinners.at(i);
+    }
+
+    // Play each region down to one team, then the rounds between regions
+    int numRound = 1;
+    for (int region = 0; region < numRegions; region++) {
+        numRound = 1;
+        while (regionTeams.at(region).size() > 1) {
+            regionTeams.at(region) = playRound(regionTeams.at(region), numRound, regionNames[region], 1);
+            numRound++;
+        }
+    }
+    vector<Team> remainingTeams;
+    for (int region = 0; region < numRegions; region++) {
+        remainingTeams.push_back(regionTeams.at(region).at(0));
+    }
+    int firstRoundBetweenRegions = numRound;
+    while (remainingTeams.size() > 1) {
+        string label = (remainingTeams.size() == 2) ? "Championship" : (remainingTeams.size() == 4) ? "Final Four" : "National";
+        remainingTeams = playRound(remainingTeams, numRound, label, 1);
+        numRound++;
+    }
+
+    tournamentRecords.clear();
+    for (int r = numRound - 1; r >= firstRoundBetweenRegions; r--) {
+        tournamentRecords.insert(tournamentRecords.end(), gamesByRound[r].begin(), gamesByRound[r].end());
+    }
+    // games of each region by round, with the play-in games at the end
+    for (int region = 0; region < numRegions; region++) {
+        for (int r = firstRoundBetweenRegions - 1; r >= 0; r--) {
+            for (int i = 0; i < gamesByRound[r].size(); i++) {
+                if (gamesByRound[r].at(i).GetRegion() == regionNames[region]) {
+                    tournamentRecords.push_back(gamesByRound[r].at(i));
+                }
+            }
+        }
+    }
+} // end generateSyntheticBracket()
+
+
+//--------------------------------------------------------------------------------
+// Time building the bracket engine for brackets of 2^6 up to 2^16 teams, to show it grows linearly
+void benchmarkBracketEngine() {
+
+    cout << "Teams      Games      Build (ms)   ns/game   Regions   Last regional round\n";
+    for (int numRounds = 6; numRounds <= 16; numRounds += 2) {
+        vector<TournamentRecord> tournamentRecords;
+        generateSyntheticBracket(numRounds, tournamentRecords);
+
+        const int numRepetitions = 5;
+        double bestMs = 1e9;
+        int numRegions = 0, lastRegionalRound = 0;
+        for (int rep = 0; rep < numRepetitions; rep++) {
+            auto start = chrono::steady_clock::now();
+            BracketEngine bracket(tournamentRecords);
+            bestMs = min(bestMs, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+            numRegions = bracket.getRegions().size();
+            lastRegionalRound = bracket.getLastRegionalRound();
+        }
+
+        cout << (1 << numRounds) + 4 << "      " << tournamentRecords.size() << "      " << bestMs << "      "
+             << bestMs * 1e6 / tournamentRecords.size() << "      " << numRegions << "         " << lastRegionalRound << "\n";
+    }
+} // end benchmarkBracketEngine()
+
+
+//--------------------------------------------------------------------------------
+// Time the bootstrap evaluation of the predictors on an archive of synthetic seasons with 1 thread up to one thread
+// per core, and check that every number of threads gives the same results
+void benchmarkBootstrap() {
+
+    const int numSeasons = 500;
+    const int numResamples = 10000;
+    PackedArchive archive;
+    for (int season = 0; season < numSeasons; season++) {
+        vector<TournamentRecord> tournamentRecords;
+        generateSyntheticBracket(6, tournamentRecords, 2022 + season);
+        archive.append(tournamentRecords);
+    }
+    vector<int> seasonStarts;
+    splitIntoSeasons(archive, seasonStarts);
+    auto loadSeason = [&](int season, vector<TournamentRecord>& tournamentRecords) {
+        archive.unpack(seasonStarts.at(season), seasonStarts.at(season + 1), tournamentRecords);
+    };
+    vector<RegionPredictor> predictors = regionPredictors();
+    cout << "Evaluating " << predictors.size() << " predictors on " << numSeasons << " synthetic seasons with "
+         << numResamples << " bootstrap resamples...\n\n";
+
+    // 1, 2, 4, ... threads, always ending with one thread per core
+    int maxThreads = defaultNumThreads();
+    vector<int> threadCounts;
+    for (int numThreads = 1; numThreads < maxThreads; numThreads *= 2) {
+        threadCounts.push_back(numThreads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    vector< vector<PredictorAccuracy> > firstResults;
+    double oneThreadMs = 0;
+    cout << "Threads    Time (ms)    Speedup\n";
+    for (int t = 0; t < threadCounts.size(); t++) {
+        int numThreads = threadCounts.at(t);
+        auto start = chrono::steady_clock::now();
+        vector< vector<PredictorAccuracy> > results = evaluateRegionPredictors(numSeasons, loadSeason, predictors, numResamples, numThreads);
+        double elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        if (numThreads == 1) {
+            oneThreadMs = elapsedMs;
+            firstResults = results;
+        }
+
+        bool sameResults = (results.size() == firstResults.size());
+        for (int p = 0; sameResults && p < results.size(); p++) {
+            for (int r = 0; r < results.at(p).size(); r++) {
+                sameResults = sameResults && results.at(p).at(r).lowerBound == firstResults.at(p).at(r).lowerBound
+                                          && results.at(p).at(r).upperBound == firstResults.at(p).at(r).upperBound;
+            }
+        }
+        cout << numThreads << "          " << elapsedMs << "        " << (oneThreadMs / elapsedMs) << "x"
+             << (sameResults ? "" : "  (RESULTS DO NOT MATCH)") << "\n";
+    }
+    displayPredictorAccuracy(predictors, firstResults);
+} // end benchmarkBootstrap()
+
+
+//--------------------------------------------------------------------------------
+// Memory the program is using (its resident set size) in kB, from /proc/self/status, or -1 if it is not available
+long residentMemoryKB() {
+
+    ifstream statusStream("/proc/self/status");
+    string row;
+    while (getline(statusStream, row)) {
+        if (row.compare(0, 6, "VmRSS:") == 0) {
+            return stol(row.substr(6));
+        }
+    }
+    return -1;
+} // end residentMemoryKB()
+
+
+//--------------------------------------------------------------------------------
+// Resident memory added by build(), in kB, or -1 if it cannot be measured. build() runs in a child process, so every
+// measurement starts from the same state, instead of reusing memory that something measured before it gave back.
+long residentMemoryAddedKB(function<void()> build) {
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        long startKB = residentMemoryKB();
+        build();
+        long addedKB = (startKB == -1) ? -1 : residentMemoryKB() - startKB;
+        ssize_t written = write(fds[1], &addedKB, sizeof(addedKB));
+        _exit(written == sizeof(addedKB) ? 0 : 1);
+    }
+    close(fds[1]);
+    long addedKB = -1;
+    if (read(fds[0], &addedKB, sizeof(addedKB)) != sizeof(addedKB)) {
+        addedKB = -1;
+    }
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+    return addedKB;
+} // end residentMemoryAddedKB()
+
+
+//--------------------------------------------------------------------------------
+// Memory used by a record, including the names that are too long to fit inside the strings themselves
+size_t recordBytes(TournamentRecord& oneRecord) {
+
+    size_t numBytes = sizeof(TournamentRecord);
+    string names[4] = {oneRecord.GetRegion(), oneRecord.GetTeam1(), oneRecord.GetTeam2(), oneRecord.GetWinningTeam()};
+    for (int i = 0; i < 4; i++) {
+        if (names[i].size() > 15) {   // short strings are stored inside the string
+            numBytes += names[i].size() + 1;
+        }
+    }
+    return numBytes;
+} // end recordBytes()
+
+
+//--------------------------------------------------------------------------------
+// Measure the memory used by an archive of 100 synthetic seasons of 16,384 teams (over a million games)
+// kept as packed games and as records, and check that unpacking gives back the same records
+void benchmarkPackedRecords() {
+
+    const int numSeasons = 100;
+    const int numRounds = 14;
+    const int numRegions = 128;   // so the ranks (1-128) fit in a packed game
+
+    // The packed archive is built one season at a time, so no records are left over from it
+    PackedArchive archive;
+    bool packed = true;
+    auto buildPacked = [&]() {
+        for (int season = 0; season < numSeasons && packed; season++) {
+            vector<TournamentRecord> tournamentRecords;
+            generateSyntheticBracket(numRounds, tournamentRecords, 2022 + season, numRegions);
+            packed = archive.append(tournamentRecords);
+        }
+        archive.shrinkToFit();
+    };
+    vector<TournamentRecord> archiveRecords;
+    auto buildRecords = [&]() {
+        for (int season = 0; season < numSeasons; season++) {
+            vector<TournamentRecord> tournamentRecords;
+            generateSyntheticBracket(numRounds, tournamentRecords, 2022 + season, numRegions);
+            archiveRecords.insert(archiveRecords.end(), tournamentRecords.begin(), tournamentRecords.end());
+        }
+    };
+
+    // Each one is measured in a process of its own, before either one is built here
+    long packedKB = residentMemoryAddedKB(buildPacked);
+    long recordKB = residentMemoryAddedKB(buildRecords);
+
+    auto start = chrono::steady_clock::now();
+    buildPacked();
+    double packedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (!packed) {
+        cout << "The synthetic seasons could not be packed.\n";
+        return;
+    }
+    start = chrono::steady_clock::now();
+    buildRecords();
+    double recordSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    size_t recordBytesUsed = archiveRecords.capacity() * sizeof(TournamentRecord) - archiveRecords.size() * sizeof(TournamentRecord);
+    for (int i = 0; i < archiveRecords.size(); i++) {
+        recordBytesUsed += recordBytes(archiveRecords.at(i));
+    }
+
+    // The analyses work on unpacked records, so unpacking has to give back exactly the same records
+    bool sameRecords = (archive.size() == archiveRecords.size());
+    for (int i = 0; i < archive.size() && sameRecords; i++) {
+        TournamentRecord unpacked = archive.at(i);
+        TournamentRecord &original = archiveRecords.at(i);
+        sameRecords = unpacked.GetRegion() == original.GetRegion() && unpacked.GetTeam1() == original.GetTeam1()
+            && unpacked.GetTeam2() == original.GetTeam2() && unpacked.GetWinningTeam() == original.GetWinningTeam()
+            && unpacked.GetRank1() == original.GetRank1() && unpacked.GetRank2() == original.GetRank2()
+            && unpacked.GetScore1() == original.GetScore1() && unpacked.GetScore2() == original.GetScore2()
+            && unpacked.GetNumRound() == original.GetNumRound() && unpacked.GetNumGame() == original.GetNumGame();
+    }
+
+    // A scan over the whole archive, adding up the ranks of the winners
+    start = chrono::steady_clock::now();
+    long recordRankSum = 0;
+    for (int i = 0; i < archiveRecords.size(); i++) {
+        TournamentRecord &oneRecord = archiveRecords.at(i);
+        recordRankSum += (oneRecord.GetWinningTeam() == oneRecord.GetTeam1()) ? oneRecord.GetRank1() : oneRecord.GetRank2();
+    }
+    double recordScanMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    long packedRankSum = 0;
+    for (int i = 0; i < archive.size(); i++) {
+        PackedGame &game = archive.getGame(i);
+        packedRankSum += (game.winningTeam == game.team1) ? game.rank1 : game.rank2;
+    }
+    double packedScanMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    auto megabytes = [](long kB) {
+        ostringstream out;
+        if (kB < 0) {
+            out << "n/a";
+        } else {
+            out << kB / 1024.0;
+        }
+        return out.str();
+    };
+
+    int numGames = archive.size();
+    cout << numSeasons << " seasons, " << numGames << " games:\n\n"
+         << "                  Bytes/game   Resident memory (MB)   Build (ms)   Scan (ms)\n"
+         << "Records           " << (double) recordBytesUsed / numGames << "        " << megabytes(recordKB) << "            "
+         << recordSeconds * 1000 << "      " << recordScanMs << "\n"
+         << "Packed games      " << (double) archive.getBytesUsed() / numGames << "        " << megabytes(packedKB) << "            "
+         << packedSeconds * 1000 << "      " << packedScanMs << "\n\n"
+         << (sameRecords && recordRankSum == packedRankSum ? "Unpacking gives back the same records.\n"
+                                                           : "The unpacked records DO NOT MATCH.\n");
+} // end benchmarkPackedRecords()
+
+
+// ----------------------------------------------------------------------
+// MENU OPTION 8 :: Run performance benchmarks
+void runBenchmarks(vector<TournamentRecord>& tournamentRecords) {
+
+    int inputBenchmark;
+    cout << "Enter a benchmark to run:\n"
+         << "   Select 1 for reading in a large archive with 1 to " << defaultNumThreads() << " threads\n"
+         << "   Select 2 for the cost of checking the data while reading it in\n"
+         << "   Select 3 for scoring a large pool against simulated tournaments, with duplicates collapsed and similar brackets clustered\n"
+         << "   Select 4 for building the bracket for 2^6 up to 2^16 teams\n"
+         << "   Select 5 for the bootstrap evaluation of the region predictors with 1 to " << defaultNumThreads() << " threads\n"
+         << "   Select 6 for the memory used by a million-game archive as records and as packed games\n"
+         << "Your choice --> ";
+    cin >> inputBenchmark;
+
+    if (inputBenchmark == 1) {
+        benchmarkParallelLoading(tournamentRecords);
+    }
+    else if (inputBenchmark == 2) {
+        benchmarkValidation(tournamentRecords);
+    }
+    else if (inputBenchmark == 3) {
+        benchmarkPoolScoring(tournamentRecords);
+    }
+    else if (inputBenchmark == 4) {
+        benchmarkBracketEngine();
+    }
+    else if (inputBenchmark == 5) {
+        benchmarkBootstrap();
+    }
+    else if (inputBenchmark == 6) {
+        benchmarkPackedRecords();
+    } else {
+        cout << "Invalid value." << endl;
+    }
+} // end runBenchmarks()
+
   
 int main() {
   
     displayWelcomeMessage();
 
-    // Prompt user for the name of the file with the data
-    string fileName;
-    cout << "\nEnter the name of the file with the data for the NCAA tournament: ";
-    cin >> fileName;
-
-    // Read in the data from the file into a vector
+    // Read in the data from the file into a vector, prompting again until the file can be used
     vector<TournamentRecord> tournamentRecords;
-    readInTournamentData(fileName, tournamentRecords);
+    while (true) {
+        // Prompt user for the name of the file with the data
+        string fileName;
+        cout << "\nEnter the name of the file with the data for the NCAA tournament: ";
+        cin >> fileName;
+        if (!cin) {
+            return 0;
+        }
+
+        vector<LoadError> errors;
+        tournamentRecords.clear();
+        bool opened = readInTournamentDataParallel(fileName, tournamentRecords, errors, defaultNumThreads());
+        bool anyRowRejected = displayLoadErrors(fileName, errors);
+        if (opened && !anyRowRejected && !tournamentRecords.empty()) {
+            break;
+        }
+        cout << "Please fix the lines listed above or choose another file.\n";
+    }
+
+    // Work out the shape of the bracket from the games
+    BracketEngine bracket(tournamentRecords);
 
     // Infinite loop to allow handling menu options
     int menuOption = 0;
@@ -434,40 +2500,55 @@ int main() {
                 << "   4. Identify the best underdog within a given round\n"
                 << "   5. Find the shoo-in and nail-biting games within a given round, or overall\n"
                 << "   6. Compare the actual brackets to your predicted brackets\n"
-                << "   7. Exit\n"
+                << "   7. Score a pool of predicted brackets\n"
+                << "   8. Run performance benchmarks\n"
+                << "   9. Check how often the region expected to win actually won, over an archive of seasons\n"
+                << "   10. Exit\n"
                 << "Your choice --> ";
         cin >> menuOption;
 
-        // If option 7 was chosen then exit the program
-        if (menuOption == 7) {
+        // If option 10 was chosen then exit the program
+        if (menuOption == 10) {
             cout << "Exiting program...";
             break;     // Break out of loop to exit program.
         }
 
         if (menuOption == 1) {
-            overallTournamentStats(tournamentRecords);
+            overallTournamentStats(tournamentRecords, bracket);
             continue;
         }
         else if (menuOption == 2) {
-            pathToChampionship(tournamentRecords);
+            pathToChampionship(tournamentRecords, bracket);
             continue;
         }
         else if (menuOption == 3) {
-            expectedChampionRegion(tournamentRecords);
+            expectedChampionRegion(tournamentRecords, bracket);
             continue;
         }
         else if (menuOption == 4) {
-            bestUnderdog(tournamentRecords);
+            bestUnderdog(tournamentRecords, bracket);
             continue;
         }
         else if (menuOption == 5) {
-            specialGames(tournamentRecords);
+            specialGames(tournamentRecords, bracket);
             continue;
         }
         else if (menuOption == 6) {
             compareBrackets(tournamentRecords);
             continue;
-        } 
+        }
+        else if (menuOption == 7) {
+            scorePool(tournamentRecords);
+            continue;
+        }
+        else if (menuOption == 8) {
+            runBenchmarks(tournamentRecords);
+            continue;
+        }
+        else if (menuOption == 9) {
+            evaluateExpectedRegion();
+            continue;
+        }
         else {
             cout << "\nInvalid value.  Please re-enter a value from the menu options below.\n";
         }
@@ -1,8 +1,21 @@
 #include <iostream>   // For Input and Output
 #include <fstream>    // For file input and output
-#include <cassert>    // For the assert statement
 #include <vector>     // For vectors
 #include <sstream>    // For reading in CSV file and splitting by commas
+#include <map>        // For looking up a game's position in the vector
+#include <set>        // For keeping the teams playing in each round in rank order
+#include <tuple>      // For ordering the teams by rank, then by position in the file
+#include <unordered_map> // For finding duplicate brackets in a pool, and the game each team last won
+#include <thread>     // For spreading the bulk undo evaluation across cores
+#include <atomic>     // For handing out bulk undo work to the threads
+#include <chrono>     // For timing the benchmarks
+#include <memory>     // For sharing tournament versions between readers and writers
+#include <mutex>      // For making writers of tournament versions take turns
+#include <random>     // For the stress test
+#include <algorithm>  // For find(), which searches within a vector
+#include <deque>      // For the blocks waiting to be written by the report writer
+#include <condition_variable> // For waking up the report writer thread
+#include <cstdio>     // For remove(), to delete the benchmark file and discarded reports, and snprintf()
 using namespace std;
 
 
@@ -47,6 +60,7 @@ class Game {
         // Getters / Accessor methods
         string getRegion(){ return region; }
         int getRoundNum(){ return roundNum; }
+        int getGameNum(){ return gameNum; }
         string getTeamOneName() { return team1Name; }
         int getTeamOneRank() { return team1Rank; }
         int getTeamOneScore() { return team1Score; }
@@ -62,11 +76,14 @@ class Game {
         void setWinner(string newWinner) { this->winningTeam = newWinner; }
         void setSubBrackets(Node* newSubBrackets) { this->subBrackets = newSubBrackets; }
 
-        // Utility function to display the game
+        // Utility functions to display the game, or write it to a stream
         void displayGame() {
-            cout << "Round " << roundNum << ", Game " << gameNum << ": "
-                 << team1Name << " vs " << team2Name << ". "
-                 << "Winner: " << winningTeam << "\n";
+            writeGame(cout);
+        }
+        void writeGame(ostream &out) {
+            out << "Round " << roundNum << ", Game " << gameNum << ": "
+                << team1Name << " vs " << team2Name << ". "
+                << "Winner: " << winningTeam << "\n";
         }
     
     private:
@@ -115,117 +132,267 @@ void displayWelcomeMessage()
 } //end displayWelcomeMessage()
 
 
+// Kinds of problems the loader can find in a file (the same codes as in main1.cpp)
+enum LoadErrorCode {
+    ERROR_FILE_NOT_OPENED = 1,
+    ERROR_COLUMN_COUNT,           // the line does not have exactly 10 columns
+    ERROR_NOT_A_NUMBER,           // a rank, score, round or game column is not a number
+    ERROR_OUT_OF_RANGE,           // a rank, round or game number is outside the range a tournament can have
+    ERROR_WINNER_NOT_A_TEAM       // the winning team is neither of the teams that played
+};
+
+// One problem found in a file. The game on the line is left out of the vector.
+struct LoadError {
+    int lineNumber;
+    LoadErrorCode code;
+    string message;
+};
+
+// The highest round number that is accepted, far more than a bracket of any size needs.
+// Round 0 holds play-in games, such as the First Four.
+const int MAX_ROUND = 64;
+
+
+//--------------------------------------------------------------------------------
+// Convert a column to a number without throwing, so a bad value can be reported instead
+bool parseNumber(const string &columnVal, int &number)
+{
+    if (columnVal.empty() || columnVal.size() > 9) {
+        return false;
+    }
+    number = 0;
+    for (int i = 0; i < columnVal.size(); i++) {
+        if (columnVal[i] < '0' || columnVal[i] > '9') {
+            return false;
+        }
+        number = number * 10 + (columnVal[i] - '0');
+    }
+    return true;
+} // end parseNumber()
+
+
 //--------------------------------------------------------------------------------
-// Read in the game data and store in a vector
-void readInGameData(string filename, vector<Game>& games) {
+// Remove spaces around a team or region name, e.g. "Iowa " in the 2022 Women's file
+void trimSpaces(string &columnVal)
+{
+    size_t first = columnVal.find_first_not_of(" \t");
+    size_t last = columnVal.find_last_not_of(" \t");
+    if (first == string::npos) {
+        columnVal.clear();
+    } else if (first > 0 || last + 1 < columnVal.size()) {
+        columnVal = columnVal.substr(first, last - first + 1);
+    }
+} // end trimSpaces()
 
-    string region, teamOne, teamTwo, winningTeam;
-    int rankOne, rankTwo, roundNumber, gameNumber, scoreOne, scoreTwo;
+
+//--------------------------------------------------------------------------------
+// Read in the game data and store in a vector, checking each line as it is read in.
+// Lines with a problem are added to errors and left out, instead of stopping the program.
+// Returns false if the file could not be opened.
+bool readInGameData(string filename, vector<Game>& games, vector<LoadError>& errors) {
 
     ifstream inStream;
     inStream.open(filename);
-    assert(inStream.fail() == false);
+    if (inStream.fail()) {
+        errors.push_back({0, ERROR_FILE_NOT_OPENED, "Could not open " + filename});
+        return false;
+    }
 
     string row;
     getline(inStream, row); // read in header from file, and ignore
+    int lineNumber = 1;
 
     // read in each line of the file
     while (getline(inStream, row)) {
+        lineNumber++;
+        // Ignore a carriage return at the end of the line, and skip blank lines
+        if (!row.empty() && row.back() == '\r') {
+            row.pop_back();
+        }
+        if (row.empty()) {
+            continue;
+        }
         stringstream s_stream(row); // create stringstream from the row
 
         // separate the line by commas into each column
-        int colNum = 0;
-        while (s_stream.good()) {
-            string columnVal;
-            getline(s_stream, columnVal, ','); // get first string delimited by comma
-
-            // use the substring to fill in the appropriate part of the BillboardRecord
-            switch (colNum) {
-                case 0:
-                    region = columnVal;
-                    break;
-                case 1:
-                    rankOne = stoi(columnVal);
-                    break;
-                case 2:
-                    teamOne = columnVal; 
-                    break;
-                case 3:
-                    if(columnVal != "") { scoreOne = stoi(columnVal); }
-                    else { scoreOne = -1; }
-                    break;
-                case 4:
-                    rankTwo = stoi(columnVal);
-                    break;
-                case 5:
-                    teamTwo = columnVal;
-                    break;
-                case 6:
-                    if(columnVal != "") { scoreTwo = stoi(columnVal); }
-                    else { scoreTwo = -1; }
-                    break;
-                case 7:
-                    winningTeam = columnVal;
-                    break;
-                case 8:
-                    roundNumber = stoi(columnVal);
-                    break;
-                case 9:
-                    gameNumber = stoi(columnVal);
-                    break;
-                default: // should not get here, because there are only 10 columns
-                    cout << "More columns in the file than expected... Exiting program" << endl;
-                    exit(0);
-                    break;
-            }
-            colNum++;
-        }
-        // Create instance of the class using the column values
-        Game oneGame;
-        oneGame = Game(region, rankOne, teamOne, scoreOne, rankTwo, teamTwo, scoreTwo, winningTeam, roundNumber, gameNumber);
-        // and add it to the vector
-        games.push_back(oneGame);
+        vector<string> columnVals;
+        string columnVal;
+        while (getline(s_stream, columnVal, ',')) {
+            columnVals.push_back(columnVal);
+        }
+        if (!row.empty() && row.back() == ',') {
+            columnVals.push_back("");   // getline does not return the empty last column
+        }
+        if (columnVals.size() != 10) {
+            errors.push_back({lineNumber, ERROR_COLUMN_COUNT, "Expected 10 columns but found " + to_string(columnVals.size())});
+            continue;
+        }
+
+        // the scores are blank in prediction files
+        int rankOne, rankTwo, scoreOne = -1, scoreTwo = -1, roundNumber, gameNumber;
+        if (!parseNumber(columnVals[1], rankOne) || !parseNumber(columnVals[4], rankTwo)
+          || (columnVals[3] != "" && !parseNumber(columnVals[3], scoreOne))
+          || (columnVals[6] != "" && !parseNumber(columnVals[6], scoreTwo))
+          || !parseNumber(columnVals[8], roundNumber) || !parseNumber(columnVals[9], gameNumber)) {
+            errors.push_back({lineNumber, ERROR_NOT_A_NUMBER, "Expected a number in a rank, score, round or game column"});
+            continue;
+        }
+        for (int col : {0, 2, 5, 7}) {
+            trimSpaces(columnVals[col]);
+        }
+        if (rankOne < 1 || rankTwo < 1) {
+            errors.push_back({lineNumber, ERROR_OUT_OF_RANGE, "Ranks must be 1 or more"});
+            continue;
+        }
+        if (roundNumber > MAX_ROUND || gameNumber < 1) {
+            errors.push_back({lineNumber, ERROR_OUT_OF_RANGE,
+                "Round " + to_string(roundNumber) + ", Game " + to_string(gameNumber) + " does not exist in the tournament"});
+            continue;
+        }
+        if (columnVals[7] != columnVals[2] && columnVals[7] != columnVals[5]) {
+            errors.push_back({lineNumber, ERROR_WINNER_NOT_A_TEAM,
+                "The winning team " + columnVals[7] + " is neither " + columnVals[2] + " nor " + columnVals[5]});
+            continue;
+        }
+
+        // Create instance of the class using the column values, and add it to the vector
+        games.push_back(Game(columnVals[0], rankOne, columnVals[2], scoreOne, rankTwo, columnVals[5], scoreTwo,
+                             columnVals[7], roundNumber, gameNumber));
 
     } // end while(getline(instream, row))
+    return true;
 
 } // end readInGameData() function
 
 
 //--------------------------------------------------------------------------------
-// Identify the sub-brackets for each game and modify the class instances in the vector accordingly
-void determineSubBrackets(vector<Game> &games) {
-
-    // Nested loop to find the sub-brackets for each game
-    // We go in reverse (csv file data is round 6 --> round 1), 
-    // starting at round 1 and going up to round 6
-    //      Note - this is so that when we add subbrackets for round 6, the subbrackets for the games
-    //             in round 5 have been determined, and so on and so forth
-    for(int i=games.size()-1; i>=0; i--) {
-        for(int j=games.size()-1; j>=0; j--) {
-            // Check that we are not looking at the same game
-            if(i==j) {
-                continue;
-            }
-            // games[j] is a sub-bracket of games[i] if it is from the previous round,
-            // and if the winning team from games[j] is one of the teams in games[i]
-            if( (games.at(j).getRoundNum() == (games.at(i).getRoundNum() - 1)) &&
-                (games.at(j).getWinner() == games.at(i).getTeamOneName() || games.at(j).getWinner() == games.at(i).getTeamTwoName()) ) {
-                    // Prepend games[j] to the linked list of sub-brackets for games[i]
-                    Node *pTemp = new Node; // new temporary Node
-                    // set data/subBracket of node to a sub-bracket game
-                    pTemp-> subBracket = games.at(j);
-                    // if list was empty, set pNext to NULL;
-                    // if it was populated, set to node previously at start of list
-                    pTemp-> pNext = games.at(i).getSubBrackets();
-                    // prepend new game to front of list
-                    games.at(i).setSubBrackets(pTemp);
+// Display the problems found in a file, one per line
+void displayLoadErrors(string filename, vector<LoadError>& errors)
+{
+    ostringstream out;
+    for (int e = 0; e < errors.size(); e++) {
+        out << filename;
+        if (errors.at(e).lineNumber > 0) {
+            out << ", line " << errors.at(e).lineNumber;
+        }
+        out << " [E" << errors.at(e).code << "]: " << errors.at(e).message << "\n";
+    }
+    cout << out.str();
+} // end displayLoadErrors()
+
+
+//--------------------------------------------------------------------------------
+// Identify the sub-brackets for each game and modify the class instances in the vector accordingly,
+// in linear time in the number of games. Returns the position of the championship game, or -1 if there are no games.
+int determineSubBrackets(vector<Game> &games) {
+
+    if (games.empty()) {
+        return -1;
+    }
+
+    // Group the games by round, keeping them in file order within a round
+    int firstRound = games.at(0).getRoundNum(), lastRound = games.at(0).getRoundNum();
+    for (int i = 0; i < games.size(); i++) {
+        firstRound = min(firstRound, games.at(i).getRoundNum());
+        lastRound = max(lastRound, games.at(i).getRoundNum());
+    }
+    vector< vector<int> > gamesInRound(lastRound - firstRound + 1);
+    for (int i = 0; i < games.size(); i++) {
+        gamesInRound.at(games.at(i).getRoundNum() - firstRound).push_back(i);
+    }
+
+    // Going up one round at a time, each team came from the last game it won, if any (a team without one is
+    // playing its first game, e.g. after a bye), so the rounds do not have to follow one another.
+    // The lists of the earlier rounds are complete by the time their games are copied into the nodes.
+    unordered_map<string, int> lastGameWon;
+    vector<bool> hasParent(games.size(), false);
+    for (int r = 0; r < gamesInRound.size(); r++) {
+        for (int g = 0; g < gamesInRound.at(r).size(); g++) {
+            int i = gamesInRound.at(r).at(g);
+            vector<int> subBrackets;
+            string teams[2] = {games.at(i).getTeamOneName(), games.at(i).getTeamTwoName()};
+            for (int t = 0; t < 2; t++) {
+                unordered_map<string, int>::iterator found = lastGameWon.find(teams[t]);
+                if (found != lastGameWon.end() && !hasParent.at(found->second)) {
+                    subBrackets.push_back(found->second);
+                    hasParent.at(found->second) = true;
                 }
+            }
+            // Prepend the sub-brackets in reverse, so the linked list is in file order
+            sort(subBrackets.begin(), subBrackets.end());
+            for (int j = subBrackets.size() - 1; j >= 0; j--) {
+                Node *pTemp = new Node; // new temporary Node
+                pTemp-> subBracket = games.at(subBrackets.at(j));
+                pTemp-> pNext = games.at(i).getSubBrackets();
+                games.at(i).setSubBrackets(pTemp);
+            }
+        }
+        for (int g = 0; g < gamesInRound.at(r).size(); g++) {
+            lastGameWon[games.at(gamesInRound.at(r).at(g)).getWinner()] = gamesInRound.at(r).at(g);
         }
     }
 
+    // The championship is the game in the last round (the first one, if the file has several)
+    return gamesInRound.back().at(0);
 } // end of determineSubBrackets() function
 
 
+//--------------------------------------------------------------------------------
+// Number of rounds the winner of a game played up to and including it, which is the most rounds the game can be undone for
+int countRoundsPlayed(Game &game)
+{
+    for (Node *currentNode = game.getSubBrackets(); currentNode != NULL; currentNode = currentNode->pNext) {
+        if (currentNode->subBracket.getWinner() == game.getWinner()) {
+            return 1 + countRoundsPlayed(currentNode->subBracket);
+        }
+    }
+    return 1;
+} // end countRoundsPlayed()
+
+
+// The game found by findSubBrackets() and its sub-brackets
+struct SubBracketQuery {
+    bool found = false;
+    Game game;
+    vector<Game> subBrackets;
+};
+
+
+//--------------------------------------------------------------------------------
+// Find the game with the given round number and winning team, and its sub-brackets
+SubBracketQuery findSubBrackets(vector<Game> &games, int numRound, string winningTeam)
+{
+    SubBracketQuery result;
+    for (int gameIndex = 0; gameIndex < games.size(); gameIndex++) {
+        // If the particular game with that round number and winning team exists...
+        if (games.at(gameIndex).getRoundNum() == numRound 
+          && games.at(gameIndex).getWinner() == winningTeam) {
+            result.found = true;
+            result.game = games.at(gameIndex);
+
+            // traverse linked list of sub-brackets
+            for (Node *currentNode = games.at(gameIndex).getSubBrackets(); currentNode != NULL; currentNode = currentNode->pNext) {
+                result.subBrackets.push_back(currentNode->subBracket);
+            }
+            break;
+        }
+    }
+    return result;
+} // end findSubBrackets()
+
+
+//--------------------------------------------------------------------------------
+// Display a list of games with one write to the console
+void displayGames(vector<Game> &gamesToDisplay)
+{
+    ostringstream out;
+    for (int i = 0; i < gamesToDisplay.size(); i++) {
+        gamesToDisplay.at(i).writeGame(out);
+    }
+    cout << out.str();
+} // end displayGames()
+
+
 // ----------------------------------------------------------------------
 // MENU OPTION 1 :: 
 void displaySubBrackets(vector<Game> &games) 
@@ -241,70 +408,54 @@ void displaySubBrackets(vector<Game> &games)
     cin.ignore();
     getline(cin, winningTeam);
 
-    for (int gameIndex = 0; gameIndex < games.size(); gameIndex++) {
-        // If the particular game with that round number and winning team exists...
-        if (games.at(gameIndex).getRoundNum() == numRound 
-          && games.at(gameIndex).getWinner() == winningTeam) {
+    SubBracketQuery result = findSubBrackets(games, numRound, winningTeam);
 
-            // 1) display game info
-            cout << "\nThe game is:\n";
-            games.at(gameIndex).displayGame();
-
-            // 2) traverse linked list 
-            Node *linkedList = games.at(gameIndex).getSubBrackets();
-            Node *currentNode = linkedList;
-
-            // 3) check for sub-brackets
-            if (currentNode == NULL) {
-                cout << "\nThis game does not have any sub-brackets." << endl;
-            } else {
-                cout << "\nSub-brackets of this game are:\n";
-                while (currentNode != NULL) {
-                    
-                    // 4) display game info for each sub-bracket
-                    currentNode->subBracket.displayGame();
-                    currentNode = currentNode -> pNext;
-                }
-            }
-            break;
-        }
+    // if no such game exists...
+    if (!result.found) {
+        cout << "Sorry, no games matching that round number and winning team were found.\n";
+        return;
+    }
 
-        // if, after looping through the entire vector, no such game exists...
-        if (gameIndex == games.size()-1 && (games.at(gameIndex).getRoundNum() != numRound 
-          || games.at(gameIndex).getWinner() != winningTeam)) {
-            cout << "Sorry, no games matching that round number and winning team were found." << endl;
-        }
+    // display game info, then the sub-brackets
+    cout << "\nThe game is:\n";
+    result.game.displayGame();
+    if (result.subBrackets.empty()) {
+        cout << "\nThis game does not have any sub-brackets.\n";
+    } else {
+        cout << "\nSub-brackets of this game are:\n";
+        displayGames(result.subBrackets);
     }
 } // end displaySubBrackets()
 
 
 // ----------------------------------------------------------------------
-// MENU OPTION 2 :: iterate data backwards for games this team won before the championship
-void findPathToChampionship(Game game) 
+// MENU OPTION 2 :: Collect the games on the path of the winning team to this game,
+// from round 1 up to and including this game
+void findPathToChampionship(Game &game, vector<Game> &path) 
 {
-    Node *linkedList = game.getSubBrackets();
-    Node *currentNode = linkedList;
-
-    // Base case: the game does not have any sub-brackets
-    if (currentNode == NULL) { 
-      return; 
-    }
-
     // Make recursive call on previous game where winning team also won
-    while (currentNode != NULL) {
+    // (base case: the game does not have any sub-brackets)
+    for (Node *currentNode = game.getSubBrackets(); currentNode != NULL; currentNode = currentNode->pNext) {
         if (currentNode->subBracket.getWinner() == game.getWinner()) {
-            findPathToChampionship(currentNode->subBracket);
-            // Display after recursion is complete to print in reverse order
-            currentNode->subBracket.displayGame(); // from first game to championship
+            findPathToChampionship(currentNode->subBracket, path);
         }
-        currentNode = currentNode -> pNext;
     }
+    // Add after recursion is complete, so the path runs from the first game to the championship
+    path.push_back(game);
+} // end findPathToChampionship()
+
+vector<Game> findPathToChampionship(Game &game)
+{
+    vector<Game> path;
+    findPathToChampionship(game, path);
+    return path;
 } // end findPathToChampionship()
 
 
 // ----------------------------------------------------------------------
 // MENU OPTION 3 :: 
-void undoChampionshipGame(Game &gameToUndo, int numRoundsToUndo) 
+// If changedGames is given, every game that is modified is added to it (its dirty path)
+void undoChampionshipGame(Game &gameToUndo, int numRoundsToUndo, vector<Game*> *changedGames = NULL) 
 {
     Node *linkedList = gameToUndo.getSubBrackets();
     Node *currentNode = linkedList;
@@ -320,6 +471,9 @@ void undoChampionshipGame(Game &gameToUndo, int numRoundsToUndo)
             // the winner was team 2, so we modify the winner to be team 1
             gameToUndo.setWinner(gameToUndo.getTeamOneName());
         }
+        if (changedGames != NULL) {
+            changedGames->push_back(&gameToUndo);
+        }
         return;
     }
 
@@ -327,7 +481,7 @@ void undoChampionshipGame(Game &gameToUndo, int numRoundsToUndo)
     while (currentNode != NULL) {
         if (currentNode->subBracket.getWinner() == gameToUndo.getWinner()) {
 
-            undoChampionshipGame(currentNode->subBracket, numRoundsToUndo-1);
+            undoChampionshipGame(currentNode->subBracket, numRoundsToUndo-1, changedGames);
           
             // Modify after recursion:
             if (gameToUndo.getTeamOneName() == gameToUndo.getWinner()) {
@@ -341,84 +495,1761 @@ void undoChampionshipGame(Game &gameToUndo, int numRoundsToUndo)
                 // this team is also the winner of this game
                 gameToUndo.setWinner(currentNode->subBracket.getWinner());
             }
+            if (changedGames != NULL) {
+                changedGames->push_back(&gameToUndo);
+            }
+            break;    // the winner only won one of the sub-brackets
         }
         currentNode = currentNode -> pNext;
     }
 } // end undoChampionshipGame()
 
 
-// ----------------------------------------------------------------------
-// Main() function of the program
-int main()
+//--------------------------------------------------------------------------------
+// Make a deep copy of a game and all of its sub-brackets. The sub-bracket lists are
+// shared between copies of a Game, so a bracket that is going to be modified needs its own
+Game copyBracket(Game &game)
 {
-    // Vector to hold tournament games
-    vector<Game> games;
+    Game gameCopy(game);
+    gameCopy.setSubBrackets(NULL);
 
-    displayWelcomeMessage();
+    // Copy the linked list in the same order, so recursion visits games in the same order
+    Node *pTail = NULL;
+    for (Node *currentNode = game.getSubBrackets(); currentNode != NULL; currentNode = currentNode->pNext) {
+        Node *pTemp = new Node(copyBracket(currentNode->subBracket), NULL);
+        if (pTail == NULL) {
+            gameCopy.setSubBrackets(pTemp);
+        } else {
+            pTail->pNext = pTemp;
+        }
+        pTail = pTemp;
+    }
+    return gameCopy;
+} // end copyBracket()
 
-    // Prompt user for the name of the file with the data
-    string fileName;
-    cout << "Enter the name of the file with the data for the NCAA tournament: ";
-    cin >> fileName;
 
-    // Read in the data from the file into a vector
-    readInGameData(fileName, games);
-    // Also identify sub-brackets for each game
-    determineSubBrackets(games);
+//--------------------------------------------------------------------------------
+// Free the sub-bracket lists of a bracket made by copyBracket()
+void deleteBracket(Game &game)
+{
+    Node *currentNode = game.getSubBrackets();
+    while (currentNode != NULL) {
+        Node *pNext = currentNode->pNext;
+        deleteBracket(currentNode->subBracket);
+        delete currentNode;
+        currentNode = pNext;
+    }
+    game.setSubBrackets(NULL);
+} // end deleteBracket()
 
-    
-    Game championshipGame = games.at(0);
-  
-    // Infinite loop to allow handling menu options
-    int menuOption = 0;
-    while (true) {
-        
-        // Prompt user for menu selection
-        cout << "\nSelect a menu option:\n"
-             << "   1. See the sub-brackets of one game\n"
-             << "   2. Display the path of the winning team to the championship\n"
-             << "   3. Undo the championship game for a given number of rounds\n"
-             << "   4. Exit\n"
-             << "Your choice --> ";
-        cin >> menuOption;
 
-        // If option 4 was chosen then exit the program
-        if (menuOption == 4) {
-            cout << "Exiting program...";
-            break;     // Break out of loop to exit program.
+//--------------------------------------------------------------------------------
+// Key used to match a game in the bracket to its position in the vector (and in the prediction files)
+string gameKey(Game &game)
+{
+    return game.getRegion() + "," + to_string(game.getRoundNum()) + "," + to_string(game.getGameNum());
+} // end gameKey()
+
+
+// The games read in from one file, with the sub-brackets and the championship game found by determineSubBrackets().
+// These are never modified after loading, so any number of versions and threads can share them.
+class LoadedTournament {
+    public:
+        LoadedTournament() {}
+        LoadedTournament(const LoadedTournament &) = delete;
+
+        ~LoadedTournament() {
+            // Each game owns the nodes of its own list; the games inside the nodes only point at other games' lists
+            for (int i = 0; i < games.size(); i++) {
+                Node *currentNode = games.at(i).getSubBrackets();
+                while (currentNode != NULL) {
+                    Node *pNext = currentNode->pNext;
+                    delete currentNode;
+                    currentNode = pNext;
+                }
+            }
         }
 
-        if (menuOption == 1) {
-            displaySubBrackets(games);
-            continue;
+        vector<Game> games;
+        int championshipIndex = -1;
+};
+
+// One immutable version of a tournament: the loaded games plus its own copy of the bracket,
+// which reflects any undos. A version is never modified once it has been published, and it
+// is freed when the last reader holding it lets go.
+class TournamentVersion {
+    public:
+        TournamentVersion(shared_ptr<LoadedTournament> theLoaded, Game &bracketToCopy) {
+            loaded = theLoaded;
+            championshipGame = copyBracket(bracketToCopy);
         }
+        TournamentVersion(const TournamentVersion &) = delete;
 
-        else if (menuOption == 2) {
-            cout << "Path to the championship:" << endl;
-            findPathToChampionship(championshipGame);
-            championshipGame.displayGame();
-            continue;
+        ~TournamentVersion() {
+            deleteBracket(championshipGame);
         }
 
-        else if (menuOption == 3) {
-            int numRoundsToUndo = 0;  
-            do {
-                cout << "Enter the number of rounds that you would like to undo (max of 6 allowed): ";
-                cin >> numRoundsToUndo;
-                cout << endl;
-                if (numRoundsToUndo < 1 || numRoundsToUndo > 6) {
-                    cout << "Invalid entry. Try again." << endl;
+        // ideally these should be private, but we are making them public to make the code a bit simpler
+        shared_ptr<LoadedTournament> loaded;
+        Game championshipGame;
+};
+
+// Publishes tournament versions, RCU-style: readers take a reference to the current version
+// without waiting on writers, and writers build a new version off to the side and swap it in.
+class TournamentStore {
+    public:
+        // Readers :: the version stays valid for as long as the reader holds on to it
+        shared_ptr<TournamentVersion> acquire() {
+            return atomic_load(&current);
+        }
+
+        // Writers :: read in a file and publish it as a new version. If the file cannot be opened or has
+        // lines with problems, these are displayed and the current version stays published; returns false.
+        bool reload(string filename) {
+            shared_ptr<LoadedTournament> loaded = make_shared<LoadedTournament>();
+            vector<LoadError> errors;
+            bool opened = readInGameData(filename, loaded->games, errors);
+            if (!opened || !errors.empty() || loaded->games.empty()) {
+                displayLoadErrors(filename, errors);
+                if (opened && errors.empty()) {
+                    cout << filename << " does not have any games.\n";
                 }
-            } while (numRoundsToUndo < 1 || numRoundsToUndo > 6);
+                return false;
+            }
+            loaded->championshipIndex = determineSubBrackets(loaded->games);
+            shared_ptr<TournamentVersion> newVersion = make_shared<TournamentVersion>(loaded, loaded->games.at(loaded->championshipIndex));
 
-          
-            // Work backwards from championship up for number of inputted rounds
-            undoChampionshipGame(championshipGame, numRoundsToUndo);
+            lock_guard<mutex> lock(writerMutex);
+            atomic_store(&current, newVersion);
+            return true;
+        }
+
+        // Writers :: undo the championship game of the current version and publish the result
+        void undo(int numRoundsToUndo) {
+            lock_guard<mutex> lock(writerMutex); // so that two undos do not both start from the same version
+            shared_ptr<TournamentVersion> oldVersion = acquire();
+            shared_ptr<TournamentVersion> newVersion = make_shared<TournamentVersion>(oldVersion->loaded, oldVersion->championshipGame);
+            undoChampionshipGame(newVersion->championshipGame, numRoundsToUndo);
+            atomic_store(&current, newVersion);
+        }
+
+    private:
+        shared_ptr<TournamentVersion> current;
+        mutex writerMutex;
+};
+
+
+//--------------------------------------------------------------------------------
+// Undo any game in the bracket for the given number of rounds, the same way undoChampionshipGame()
+// does, and then carry the new winner up through every later game the old winner played in
+// If changedGames is given, every game that is modified is added to it (its dirty path)
+bool undoGameInBracket(Game &currentGame, string targetKey, int targetRound, int numRoundsToUndo,
+                       vector<Game*> *changedGames = NULL)
+{
+    // Base case: this is the game where the undo begins
+    if (currentGame.getRoundNum() == targetRound && gameKey(currentGame) == targetKey) {
+        undoChampionshipGame(currentGame, numRoundsToUndo, changedGames);
+        return true;
+    }
+
+    // Games in earlier rounds cannot contain the target game
+    if (currentGame.getRoundNum() <= targetRound) {
+        return false;
+    }
+
+    Node *currentNode = currentGame.getSubBrackets();
+    while (currentNode != NULL) {
+        string oldWinner = currentNode->subBracket.getWinner();
+
+        if (undoGameInBracket(currentNode->subBracket, targetKey, targetRound, numRoundsToUndo, changedGames)) {
+            string newWinner = currentNode->subBracket.getWinner();
+
+            // Modify after recursion: the new winner takes the old winner's place in this game
+            if (currentGame.getTeamOneName() == oldWinner) {
+                currentGame.setTeamOneName(newWinner);
+            } else if (currentGame.getTeamTwoName() == oldWinner) {
+                currentGame.setTeamTwoName(newWinner);
+            }
+            // and if the old winner won this game too, so does the new winner
+            if (currentGame.getWinner() == oldWinner) {
+                currentGame.setWinner(newWinner);
+            }
+            if (changedGames != NULL && oldWinner != newWinner) {
+                changedGames->push_back(&currentGame);
+            }
+            return true;
+        }
+        currentNode = currentNode -> pNext;
+    }
+    return false;
+} // end undoGameInBracket()
+
+
+//--------------------------------------------------------------------------------
+// Record the winner of every game in the bracket at the game's position in the vector
+void collectWinners(Game &game, map<string, int> &gameIndexByKey, vector<string> &winners)
+{
+    map<string, int>::iterator found = gameIndexByKey.find(gameKey(game));
+    if (found != gameIndexByKey.end()) {
+        winners.at(found->second) = game.getWinner();
+    }
+
+    for (Node *currentNode = game.getSubBrackets(); currentNode != NULL; currentNode = currentNode->pNext) {
+        collectWinners(currentNode->subBracket, gameIndexByKey, winners);
+    }
+} // end collectWinners()
+
+
+//--------------------------------------------------------------------------------
+// Score a set of winners against one pool entry: the round number times 5 for each correct winner
+int scorePrediction(vector<Game> &games, vector<string> &winners, vector<Game> &prediction)
+{
+    int score = 0;
+    // Note that this works because we assume that the files list the games in the same order
+    for (int i = 0; i < games.size() && i < prediction.size(); i++) {
+        if (winners.at(i) == prediction.at(i).getWinner()) {
+            score += games.at(i).getRoundNum() * 5;
+        }
+    }
+    return score;
+} // end scorePrediction()
+
+
+// The outcome of undoing one game for one number of rounds
+struct Counterfactual {
+    int gameIndex;               // position of the undone game in the vector
+    int numRoundsUndone;
+    string champion;
+    vector<int> poolScores;      // score of each pool entry in the modified bracket
+    vector<int> poolScoreChanges; // and how much it changed from the current bracket
+};
+
+
+//--------------------------------------------------------------------------------
+// Evaluate every undo for every game at once, without modifying the tournament version.
+// The result is indexed [game index][number of rounds undone - 1]; a game can be undone for 1 round up to
+// the number of rounds its winner played (see countRoundsPlayed()).
+vector< vector<Counterfactual> > evaluateAllCounterfactuals(TournamentVersion &version, vector< vector<Game> > &pool, int numThreads)
+{
+    // The version is immutable, so the threads can all copy from its bracket at once
+    vector<Game> &games = version.loaded->games;
+    Game &snapshot = version.championshipGame;
+
+    map<string, int> gameIndexByKey;
+    for (int i = 0; i < games.size(); i++) {
+        gameIndexByKey[gameKey(games.at(i))] = i;
+    }
+
+    // Scores of the pool entries in the current bracket, to report how each undo changes them
+    vector<string> currentWinners(games.size());
+    collectWinners(snapshot, gameIndexByKey, currentWinners);
+    vector<int> currentScores;
+    for (int entry = 0; entry < pool.size(); entry++) {
+        currentScores.push_back(scorePrediction(games, currentWinners, pool.at(entry)));
+    }
+
+    // Lay out the matrix up front, so each thread only writes to its own cells
+    vector< vector<Counterfactual> > results(games.size());
+    vector< pair<int, int> > tasks;
+    for (int i = 0; i < games.size(); i++) {
+        int maxRounds = countRoundsPlayed(games.at(i));
+        for (int numRounds = 1; numRounds <= maxRounds; numRounds++) {
+            Counterfactual cell;
+            cell.gameIndex = i;
+            cell.numRoundsUndone = numRounds;
+            results.at(i).push_back(cell);
+            tasks.push_back(make_pair(i, numRounds));
+        }
+    }
+
+    // Each thread takes the next task until there are none left
+    atomic<int> nextTask(0);
+    auto worker = [&]() {
+        vector<string> winners(games.size());
+        int task;
+        while ((task = nextTask++) < (int) tasks.size()) {
+            int gameIndex = tasks.at(task).first;
+            int numRounds = tasks.at(task).second;
+            Counterfactual &cell = results.at(gameIndex).at(numRounds - 1);
+
+            Game bracket = copyBracket(snapshot);
+            undoGameInBracket(bracket, gameKey(games.at(gameIndex)), games.at(gameIndex).getRoundNum(), numRounds);
+
+            collectWinners(bracket, gameIndexByKey, winners);
+            cell.champion = bracket.getWinner();
+            for (int entry = 0; entry < pool.size(); entry++) {
+                int score = scorePrediction(games, winners, pool.at(entry));
+                cell.poolScores.push_back(score);
+                cell.poolScoreChanges.push_back(score - currentScores.at(entry));
+            }
+            deleteBracket(bracket);
+        }
+    };
+
+    vector<thread> threads;
+    for (int t = 1; t < numThreads; t++) {
+        threads.push_back(thread(worker));
+    }
+    worker(); // the calling thread does its share too
+    for (int t = 0; t < threads.size(); t++) {
+        threads.at(t).join();
+    }
+
+    return results;
+} // end evaluateAllCounterfactuals()
+
+
+//--------------------------------------------------------------------------------
+// Number of threads to use for parallel work
+int defaultNumThreads()
+{
+    int numThreads = thread::hardware_concurrency();
+    return (numThreads > 0) ? numThreads : 1;
+} // end defaultNumThreads()
+
+
+// Formats the report writer can write
+enum ReportFormat { REPORT_CSV = 1, REPORT_JSON = 2 };
+
+// Writes the rows of a report to a file on a background thread. Rows are formatted into a buffer, and each
+// full buffer is handed to the writer thread, so an analysis never waits for the file (or for a flush per line).
+// If the file cannot be opened, isOpen() returns false, no thread is started and the rows are ignored.
+class ReportWriter {
+    public:
+        ReportWriter(string filename, ReportFormat theFormat, vector<string> theColumns) {
+            outStream.open(filename, ios::binary);
+            fileName = filename;
+            format = theFormat;
+            columns = theColumns;
+            numRows = 0;
+            opened = !outStream.fail();
+            finished = !opened;
+            if (!opened) {
+                return;
+            }
+
+            if (format == REPORT_CSV) {
+                for (int col = 0; col < columns.size(); col++) {
+                    buffer += (col > 0 ? "," : "") + csvField(columns.at(col));
+                }
+                buffer += "\n";
+            } else {
+                buffer += "[\n";
+            }
+            writerThread = thread(&ReportWriter::writeBlocks, this);
+        }
+        ReportWriter(const ReportWriter &) = delete;
+
+        ~ReportWriter() {
+            finish();
+        }
+
+        // Add one row, with one field per column
+        void writeRow(const vector<string> &fields) {
+            if (!opened) {
+                return;
+            }
+            if (format == REPORT_CSV) {
+                for (int col = 0; col < fields.size(); col++) {
+                    buffer += (col > 0 ? "," : "") + csvField(fields.at(col));
+                }
+                buffer += "\n";
+            } else {
+                buffer += (numRows > 0 ? ",\n  {" : "  {");
+                for (int col = 0; col < fields.size() && col < columns.size(); col++) {
+                    buffer += (col > 0 ? ", " : "") + jsonString(columns.at(col)) + ": "
+                            + (isNumber(fields.at(col)) ? fields.at(col) : jsonString(fields.at(col)));
+                }
+                buffer += "}";
+            }
+            numRows++;
+
+            if (buffer.size() >= BLOCK_SIZE) {
+                handOffBuffer();
+            }
+        }
+
+        // Write out the rest of the report and wait for the writer thread to finish
+        void finish() {
+            if (finished) {
+                return;
+            }
+            if (format == REPORT_JSON) {
+                buffer += (numRows > 0 ? "\n]\n" : "]\n");
+            }
+            handOffBuffer();
+            {
+                lock_guard<mutex> lock(queueMutex);
+                finished = true;
+            }
+            queueChanged.notify_all();
+            writerThread.join();
+            outStream.close();
+        }
+
+        // Stop without writing anything more and delete the file, e.g. when another file of the same batch
+        // could not be opened
+        void discard() {
+            if (!opened) {
+                return;
+            }
+            if (!finished) {
+                {
+                    lock_guard<mutex> lock(queueMutex);
+                    blocks.clear();
+                    finished = true;
+                }
+                queueChanged.notify_all();
+                writerThread.join();
+            }
+            outStream.close();
+            remove(fileName.c_str());
+            buffer.clear();
+            opened = false;
+        }
+
+        bool isOpen() { return opened; }
+        long getNumRows() { return numRows; }
+
+    private:
+        static const size_t BLOCK_SIZE = 1 << 16;   // bytes of formatted rows per write
+        static const size_t MAX_QUEUED_BLOCKS = 64;  // so a fast analysis cannot use up all the memory
+
+        // Give the buffer to the writer thread, waiting if it has fallen too far behind
+        void handOffBuffer() {
+            unique_lock<mutex> lock(queueMutex);
+            queueChanged.wait(lock, [this]() { return blocks.size() < MAX_QUEUED_BLOCKS; });
+            blocks.push_back(move(buffer));
+            buffer.clear();
+            buffer.reserve(BLOCK_SIZE + 1024);
+            lock.unlock();
+            queueChanged.notify_all();
+        }
+
+        // Background thread :: write each block to the file as it arrives
+        void writeBlocks() {
+            while (true) {
+                unique_lock<mutex> lock(queueMutex);
+                queueChanged.wait(lock, [this]() { return !blocks.empty() || finished; });
+                if (blocks.empty()) {
+                    return;   // finished, and everything has been written
+                }
+                string block = move(blocks.front());
+                blocks.pop_front();
+                lock.unlock();
+                queueChanged.notify_all();
+
+                outStream.write(block.data(), block.size());
+            }
+        }
+
+        static bool isNumber(const string &field) {
+            if (field.empty() || field.size() > 15) {
+                return false;
+            }
+            for (int i = 0; i < field.size(); i++) {
+                if (!isdigit((unsigned char) field[i]) && !(i == 0 && field[i] == '-' && field.size() > 1)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Quote a field if it has a comma, quote or line break in it
+        static string csvField(const string &field) {
+            if (field.find_first_of(",\"\n") == string::npos) {
+                return field;
+            }
+            string quoted = "\"";
+            for (int i = 0; i < field.size(); i++) {
+                quoted += (field[i] == '"') ? "\"\"" : string(1, field[i]);
+            }
+            return quoted + "\"";
+        }
+
+        static string jsonString(const string &field) {
+            string quoted = "\"";
+            for (int i = 0; i < field.size(); i++) {
+                if (field[i] == '"' || field[i] == '\\') {
+                    quoted += '\\';
+                    quoted += field[i];
+                } else if (field[i] == '\n') {
+                    quoted += "\\n";
+                } else if (field[i] == '\r') {
+                    quoted += "\\r";
+                } else if (field[i] == '\t') {
+                    quoted += "\\t";
+                } else if ((unsigned char) field[i] < 0x20) {
+                    // JSON does not allow any other control character inside a string either
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char) field[i]);
+                    quoted += escaped;
+                } else {
+                    quoted += field[i];
+                }
+            }
+            return quoted + "\"";
+        }
+
+        ofstream outStream;
+        string fileName;
+        ReportFormat format;
+        vector<string> columns;
+        string buffer;
+        long numRows;
+        bool opened;
+
+        deque<string> blocks;      // full buffers waiting to be written
+        mutex queueMutex;
+        condition_variable queueChanged;
+        bool finished;
+        thread writerThread;
+};
+
+
+//--------------------------------------------------------------------------------
+// Prompt the user for the prediction files in the pool and read each one in. Entries that predict the same
+// winner for every game are only kept once in the pool, so each unique bracket is evaluated once;
+// entryToUnique gives the position in the pool of each entry's bracket.
+void readInPool(vector< vector<Game> > &pool, vector<int> &entryToUnique)
+{
+    unordered_map<string, int> uniqueByWinners;
+
+    cout << "Enter the names of the prediction files in the pool, then 'done': ";
+    string fileName;
+    while (cin >> fileName && fileName != "done") {
+        // An entry with a line left out would be scored against the wrong games, so the whole file is left out
+        vector<Game> prediction;
+        vector<LoadError> errors;
+        if (!readInGameData(fileName, prediction, errors) || !errors.empty()) {
+            displayLoadErrors(fileName, errors);
+            cout << fileName << " was left out of the pool.\n";
+            continue;
+        }
+
+        string winners;
+        for (int i = 0; i < prediction.size(); i++) {
+            winners += prediction.at(i).getWinner() + "\n";
+        }
+        unordered_map<string, int>::iterator found = uniqueByWinners.find(winners);
+        if (found == uniqueByWinners.end()) {
+            found = uniqueByWinners.insert(make_pair(winners, (int) pool.size())).first;
+            pool.push_back(prediction);
+        }
+        entryToUnique.push_back(found->second);
+    }
+    cout << entryToUnique.size() << " entries, " << pool.size() << " unique brackets.\n";
+} // end readInPool()
+
+
+// ----------------------------------------------------------------------
+// MENU OPTION 4 :: Evaluate every undo for every game and number of rounds at once
+void displayAllCounterfactuals(TournamentVersion &version)
+{
+    vector< vector<Game> > pool;
+    vector<int> entryToUnique;
+    readInPool(pool, entryToUnique);
+
+    vector<Game> &games = version.loaded->games;
+    vector< vector<Counterfactual> > results = evaluateAllCounterfactuals(version, pool, defaultNumThreads());
+
+    // Format the whole table first, then display it with one write
+    ostringstream out;
+    for (int i = 0; i < results.size(); i++) {
+        out << "\n" << games.at(i).getRegion() << ", Round " << games.at(i).getRoundNum()
+            << ", Game " << games.at(i).getGameNum() << ":\n";
+        for (int j = 0; j < results.at(i).size(); j++) {
+            Counterfactual &cell = results.at(i).at(j);
+            out << "   Undo " << cell.numRoundsUndone << " round(s) -> champion: " << cell.champion;
+            if (!pool.empty()) {
+                out << ", score changes:";
+                for (int entry = 0; entry < entryToUnique.size(); entry++) {
+                    int change = cell.poolScoreChanges.at(entryToUnique.at(entry));
+                    out << " " << (change >= 0 ? "+" : "") << change;
+                }
+            }
+            out << "\n";
+        }
+    }
+    cout << out.str();
+} // end displayAllCounterfactuals()
+
+
+//--------------------------------------------------------------------------------
+// Collect every game in the bracket, from the championship down, with the games each team played
+void collectGamesByTeam(Game &game, vector<Game> &allGames, map<string, vector<Game> > &gamesByTeam)
+{
+    allGames.push_back(game);
+    gamesByTeam[game.getTeamOneName()].push_back(game);
+    gamesByTeam[game.getTeamTwoName()].push_back(game);
+    for (Node *currentNode = game.getSubBrackets(); currentNode != NULL; currentNode = currentNode->pNext) {
+        collectGamesByTeam(currentNode->subBracket, allGames, gamesByTeam);
+    }
+} // end collectGamesByTeam()
+
+
+// ----------------------------------------------------------------------
+// MENU OPTION 7 :: Write reports for every game, every team and every pool entry to files
+void writeBatchReports(TournamentVersion &version)
+{
+    string baseName;
+    cout << "Enter the name to start the report files with: ";
+    cin >> baseName;
+    int inputFormat;
+    cout << "Enter the format of the reports (1 for CSV, 2 for JSON): ";
+    cin >> inputFormat;
+    ReportFormat format = (inputFormat == 2) ? REPORT_JSON : REPORT_CSV;
+    string extension = (format == REPORT_JSON) ? ".json" : ".csv";
+
+    // Open all of the files before doing any of the work
+    ReportWriter gamesReport(baseName + "_games" + extension, format,
+        {"region", "round", "game", "team1", "team2", "winner", "sub-brackets"});
+    ReportWriter pathsReport(baseName + "_paths" + extension, format,
+        {"team", "round", "game", "region", "team1", "team2", "winner"});
+    ReportWriter undosReport(baseName + "_undos" + extension, format,
+        {"region", "round", "game", "rounds-undone", "champion", "entry", "score", "score-change"});
+    if (!gamesReport.isOpen() || !pathsReport.isOpen() || !undosReport.isOpen()) {
+        // Delete the files that did open, so a failed batch leaves nothing behind
+        gamesReport.discard();
+        pathsReport.discard();
+        undosReport.discard();
+        cout << "Could not open the report files starting with " << baseName << ".\n";
+        return;
+    }
+
+    vector< vector<Game> > pool;
+    vector<int> entryToUnique;
+    readInPool(pool, entryToUnique);
+
+    auto start = chrono::steady_clock::now();
+    vector<Game> allGames;
+    map<string, vector<Game> > gamesByTeam;
+    collectGamesByTeam(version.championshipGame, allGames, gamesByTeam);
+
+    // Every game and its sub-brackets
+    for (int i = 0; i < allGames.size(); i++) {
+        Game &game = allGames.at(i);
+        string subBrackets;
+        for (Node *currentNode = game.getSubBrackets(); currentNode != NULL; currentNode = currentNode->pNext) {
+            subBrackets += (subBrackets.empty() ? "" : "; ") + currentNode->subBracket.getRegion()
+                + " Round " + to_string(currentNode->subBracket.getRoundNum())
+                + " Game " + to_string(currentNode->subBracket.getGameNum());
+        }
+        gamesReport.writeRow({game.getRegion(), to_string(game.getRoundNum()), to_string(game.getGameNum()),
+                              game.getTeamOneName(), game.getTeamTwoName(), game.getWinner(), subBrackets});
+    }
+
+    // The path of every team, from round 1 up to the game it lost (or the championship)
+    for (map<string, vector<Game> >::iterator team = gamesByTeam.begin(); team != gamesByTeam.end(); team++) {
+        vector<Game> &path = team->second;
+        sort(path.begin(), path.end(), [](Game &a, Game &b) { return a.getRoundNum() < b.getRoundNum(); });
+        for (int i = 0; i < path.size(); i++) {
+            pathsReport.writeRow({team->first, to_string(path.at(i).getRoundNum()), to_string(path.at(i).getGameNum()),
+                                  path.at(i).getRegion(), path.at(i).getTeamOneName(), path.at(i).getTeamTwoName(),
+                                  path.at(i).getWinner()});
+        }
+    }
+
+    // Every undo of every game, with the score of every pool entry
+    vector<Game> &games = version.loaded->games;
+    vector< vector<Counterfactual> > results = evaluateAllCounterfactuals(version, pool, defaultNumThreads());
+    for (int i = 0; i < results.size(); i++) {
+        for (int j = 0; j < results.at(i).size(); j++) {
+            Counterfactual &cell = results.at(i).at(j);
+            vector<string> row = {games.at(i).getRegion(), to_string(games.at(i).getRoundNum()),
+                                  to_string(games.at(i).getGameNum()), to_string(cell.numRoundsUndone), cell.champion, "", "", ""};
+            if (entryToUnique.empty()) {
+                undosReport.writeRow(row);
+            }
+            for (int entry = 0; entry < entryToUnique.size(); entry++) {
+                row.at(5) = to_string(entry + 1);
+                row.at(6) = to_string(cell.poolScores.at(entryToUnique.at(entry)));
+                row.at(7) = to_string(cell.poolScoreChanges.at(entryToUnique.at(entry)));
+                undosReport.writeRow(row);
+            }
+        }
+    }
+
+    gamesReport.finish();
+    pathsReport.finish();
+    undosReport.finish();
+    double elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << "Wrote " << gamesReport.getNumRows() << " games, " << pathsReport.getNumRows() << " path rows and "
+         << undosReport.getNumRows() << " undo rows to " << baseName << "_*" << extension
+         << " in " << elapsedMs << " ms.\n";
+} // end writeBatchReports()
+
+
+// A private copy of the bracket that can be undone over and over, with the analyses kept up to date as it changes.
+// An undo only changes the games on one path through the bracket, so instead of rescanning every game after each
+// undo, only the games that changed are taken out of the rank sums, underdog lists and pool scores and put back in.
+class IncrementalBracket {
+    public:
+        IncrementalBracket(TournamentVersion &version, vector< vector<Game> > &thePool) {
+            loaded = version.loaded;
+            bracket = copyBracket(version.championshipGame);
+            vector<Game> &games = loaded->games;
+
+            // Rank of each team, from the games as they were read in (an undo does not change it)
+            map<int, int> gamesInRound;
+            for (int i = 0; i < games.size(); i++) {
+                gameIndexByKey[gameKey(games.at(i))] = i;
+                rankOfTeam[internTeam(games.at(i).getTeamOneName())] = games.at(i).getTeamOneRank();
+                rankOfTeam[internTeam(games.at(i).getTeamTwoName())] = games.at(i).getTeamTwoRank();
+                lastRound = max(lastRound, games.at(i).getRoundNum());
+                gamesInRound[games.at(i).getRoundNum()]++;
+            }
+
+            // The shape of the bracket, worked out the same way as main1.cpp's BracketEngine: the main round is the
+            // first round with the whole field (the most games), its region labels are the regions in file order,
+            // and the last round with a game labeled with one of them is the last round within the regions
+            for (map<int, int>::iterator round = gamesInRound.begin(); round != gamesInRound.end(); round++) {
+                if (round->second > gamesInRound[mainRound]) {
+                    mainRound = round->first;
+                }
+            }
+            for (int i = 0; i < games.size(); i++) {
+                if (games.at(i).getRoundNum() == mainRound
+                  && find(regions.begin(), regions.end(), games.at(i).getRegion()) == regions.end()) {
+                    regions.push_back(games.at(i).getRegion());
+                }
+            }
+            regionOfGame.assign(games.size(), -1);
+            for (int i = 0; i < games.size(); i++) {
+                vector<string>::iterator found = find(regions.begin(), regions.end(), games.at(i).getRegion());
+                if (found != regions.end()) {
+                    regionOfGame.at(i) = found - regions.begin();
+                    lastRegionalRound = max(lastRegionalRound, games.at(i).getRoundNum());
+                }
+            }
+
+            // Find the position in the vector of each game in the private bracket
+            gameInBracket.assign(games.size(), NULL);
+            indexGames(bracket);
+
+            // The winner each pool entry predicts for each game
+            for (int entry = 0; entry < thePool.size(); entry++) {
+                vector<int> predicted(games.size(), -1);
+                for (int i = 0; i < games.size() && i < thePool.at(entry).size(); i++) {
+                    predicted.at(i) = internTeam(thePool.at(entry).at(i).getWinner());
+                }
+                predictedWinners.push_back(predicted);
+            }
+
+            recomputeAll();
+        }
+        IncrementalBracket(const IncrementalBracket &) = delete;
+
+        ~IncrementalBracket() {
+            deleteBracket(bracket);
+        }
+
+        // Undo a game for the given number of rounds (see undoGameInBracket()), and update the analyses
+        // for only the games that changed. Returns the number of games that changed.
+        int undo(int gameIndex, int numRoundsToUndo) {
+            vector<Game*> changedGames;
+            Game &game = loaded->games.at(gameIndex);
+            undoGameInBracket(bracket, gameKey(game), game.getRoundNum(), numRoundsToUndo, &changedGames);
+            for (int i = 0; i < changedGames.size(); i++) {
+                int changedIndex = indexOfGame[changedGames.at(i)];
+                removeGame(changedIndex);
+                readGame(changedIndex);
+                addGame(changedIndex);
+            }
+            return changedGames.size();
+        }
+
+        // Undo a game for the given number of rounds, then rescan every game, the way the analyses did before
+        void undoAndRecomputeAll(int gameIndex, int numRoundsToUndo) {
+            Game &game = loaded->games.at(gameIndex);
+            undoGameInBracket(bracket, gameKey(game), game.getRoundNum(), numRoundsToUndo);
+            recomputeAll();
+        }
+
+        // Rescan every game in the bracket and rebuild the analyses from scratch
+        void recomputeAll() {
+            int numGames = loaded->games.size();
+            team1.assign(numGames, -1);
+            team2.assign(numGames, -1);
+            winner.assign(numGames, -1);
+            rankSums.assign(lastRound + 1, vector<int>(regions.size(), 0));
+            underdogs.assign(lastRound + 1, set< tuple<int, int, int> >());
+            favorites.assign(lastRound + 1, set< tuple<int, int, int> >());
+            poolScores.assign(predictedWinners.size(), 0);
+            for (int i = 0; i < numGames; i++) {
+                readGame(i);
+                addGame(i);
+            }
+        }
+
+        // Find the position in the vector of the game with the given round number and (current) winning team
+        int findGame(int numRound, string winningTeam) {
+            for (int i = 0; i < winner.size(); i++) {
+                if (loaded->games.at(i).getRoundNum() == numRound && teamNames.at(winner.at(i)) == winningTeam) {
+                    return i;
+                }
+            }
+            return -1;
+        }
+
+        // Region expected to win the championship based on a round, the same way main1.cpp works it out:
+        // for the rounds after the main round within the regions, the region with the lowest sum of the ranks of
+        // the winners in that round (ties go to the first region), and for the first round between regions
+        // (the Final Four), the region of the game that sent the best ranking team to it
+        string expectedChampionRegion(int numRound) {
+            if (regions.empty() || numRound <= mainRound || numRound > lastRegionalRound + 1 || numRound > lastRound) {
+                return "";
+            }
+            if (numRound <= lastRegionalRound) {
+                vector<int> &sums = rankSums.at(numRound);
+                return regions.at(min_element(sums.begin(), sums.end()) - sums.begin());
+            }
+            if (favorites.at(numRound).empty()) {
+                return "";
+            }
+            const tuple<int, int, int> &best = *favorites.at(numRound).begin();
+            int gameIndex = get<1>(best);
+            int team = (get<2>(best) == 1) ? team1.at(gameIndex) : team2.at(gameIndex);
+            Game *game = (gameInBracket.at(gameIndex) != NULL) ? gameInBracket.at(gameIndex) : &loaded->games.at(gameIndex);
+            for (Node *currentNode = game->getSubBrackets(); currentNode != NULL; currentNode = currentNode->pNext) {
+                if (currentNode->subBracket.getWinner() == teamNames.at(team)) {
+                    return currentNode->subBracket.getRegion();
+                }
+            }
+            return "";
+        }
+
+        // Worst ranking team playing in a round (the first one in the file if there is a tie), and its rank
+        pair<string, int> bestUnderdog(int numRound) {
+            if (numRound < 0 || numRound > lastRound || underdogs.at(numRound).empty()) {
+                return make_pair(string(""), 0);
+            }
+            const tuple<int, int, int> &worst = *underdogs.at(numRound).begin();
+            int team = (get<2>(worst) == 1) ? team1.at(get<1>(worst)) : team2.at(get<1>(worst));
+            return make_pair(teamNames.at(team), -get<0>(worst));
+        }
+
+        vector<int> &getPoolScores() { return poolScores; }
+        Game &getChampionshipGame() { return bracket; }
+        int getMainRound() { return mainRound; }
+        int getLastRound() { return lastRound; }
+
+        // Most rounds a game can be undone for, given the undos so far
+        int getRoundsPlayed(int gameIndex) {
+            return countRoundsPlayed(gameInBracket.at(gameIndex) != NULL ? *gameInBracket.at(gameIndex) : loaded->games.at(gameIndex));
+        }
+
+    private:
+        // Give each team name a number, so games can be compared without comparing strings
+        int internTeam(string teamName) {
+            unordered_map<string, int>::iterator found = teamIds.find(teamName);
+            if (found != teamIds.end()) {
+                return found->second;
+            }
+            teamIds[teamName] = teamNames.size();
+            teamNames.push_back(teamName);
+            return teamNames.size() - 1;
+        }
+
+        void indexGames(Game &game) {
+            map<string, int>::iterator found = gameIndexByKey.find(gameKey(game));
+            if (found != gameIndexByKey.end()) {
+                gameInBracket.at(found->second) = &game;
+                indexOfGame[&game] = found->second;
+            }
+            for (Node *currentNode = game.getSubBrackets(); currentNode != NULL; currentNode = currentNode->pNext) {
+                indexGames(currentNode->subBracket);
+            }
+        }
+
+        // Copy the teams and winner of a game from the private bracket
+        void readGame(int i) {
+            Game *game = (gameInBracket.at(i) != NULL) ? gameInBracket.at(i) : &loaded->games.at(i);
+            team1.at(i) = internTeam(game->getTeamOneName());
+            team2.at(i) = internTeam(game->getTeamTwoName());
+            winner.at(i) = internTeam(game->getWinner());
+        }
+
+        // Add a game to the analyses (sign 1), or take it back out (sign -1)
+        void updateGame(int i, int sign) {
+            int numRound = loaded->games.at(i).getRoundNum();
+            if (numRound < 0) {
+                return;
+            }
+            if (regionOfGame.at(i) != -1) {
+                rankSums.at(numRound).at(regionOfGame.at(i)) += sign * rankOfTeam[winner.at(i)];
+            }
+            // Ordered by worst rank, then file order, then team 1 before team 2 (and by best rank for the favorites)
+            tuple<int, int, int> underdog1(-rankOfTeam[team1.at(i)], i, 1), underdog2(-rankOfTeam[team2.at(i)], i, 2);
+            tuple<int, int, int> favorite1(rankOfTeam[team1.at(i)], i, 1), favorite2(rankOfTeam[team2.at(i)], i, 2);
+            if (sign > 0) {
+                underdogs.at(numRound).insert(underdog1);
+                underdogs.at(numRound).insert(underdog2);
+                favorites.at(numRound).insert(favorite1);
+                favorites.at(numRound).insert(favorite2);
+            } else {
+                underdogs.at(numRound).erase(underdog1);
+                underdogs.at(numRound).erase(underdog2);
+                favorites.at(numRound).erase(favorite1);
+                favorites.at(numRound).erase(favorite2);
+            }
+            int points = numRound * 5;
+            for (int entry = 0; entry < predictedWinners.size(); entry++) {
+                if (predictedWinners.at(entry).at(i) == winner.at(i)) {
+                    poolScores.at(entry) += sign * points;
+                }
+            }
+        }
+        void addGame(int i) { updateGame(i, 1); }
+        void removeGame(int i) { updateGame(i, -1); }
+
+        shared_ptr<LoadedTournament> loaded;
+        Game bracket;                          // the private copy that is undone
+        map<string, int> gameIndexByKey;
+        vector<Game*> gameInBracket;           // game in the private bracket at each position in the vector
+        unordered_map<Game*, int> indexOfGame; // and the other way around
+        int lastRound = 0;
+        int mainRound = 0;                     // the first round with the whole field
+        int lastRegionalRound = -1;            // the last round with games within the regions
+
+        unordered_map<string, int> teamIds;
+        vector<string> teamNames;
+        unordered_map<int, int> rankOfTeam;
+        vector<string> regions;                // region labels of the main round, in the order they are listed in the file
+        vector<int> regionOfGame;              // position in regions of the region each game was played in, or -1
+
+        // Current teams and winner of each game, as team numbers
+        vector<int> team1, team2, winner;
+
+        // The analyses, kept up to date as games change
+        vector< vector<int> > rankSums;                   // [round][region] sum of the ranks of the winners
+        vector< set< tuple<int, int, int> > > underdogs;  // [round] (-rank, game, team 1 or 2) of every team playing
+        vector< set< tuple<int, int, int> > > favorites;  // [round] (rank, game, team 1 or 2) of every team playing
+        vector< vector<int> > predictedWinners;           // [entry][game]
+        vector<int> poolScores;                           // [entry]
+};
+
+
+// ----------------------------------------------------------------------
+// MENU OPTION 8 :: Undo games one after another in a private copy of the bracket, querying it after each undo
+void whatIfSession(TournamentVersion &version)
+{
+    vector< vector<Game> > pool;
+    vector<int> entryToUnique;
+    readInPool(pool, entryToUnique);
+    IncrementalBracket session(version, pool);
+
+    while (true) {
+        int numRound = -1;
+        cout << "\nEnter the round number of the game to undo (-1 to stop): ";
+        cin >> numRound;
+        if (numRound == -1 || !cin) {
+            break;
+        }
+        string winningTeam;
+        cout << "Enter the winning team of the game: ";
+        cin.ignore();
+        getline(cin, winningTeam);
+        int gameIndex = session.findGame(numRound, winningTeam);
+        if (gameIndex == -1) {
+            cout << "Sorry, no games matching that round number and winning team were found.\n";
+            continue;
+        }
+        int numRoundsToUndo = 0;
+        int maxRounds = session.getRoundsPlayed(gameIndex);
+        cout << "Enter the number of rounds that you would like to undo (max of " << maxRounds << " allowed): ";
+        cin >> numRoundsToUndo;
+        if (numRoundsToUndo < 1 || numRoundsToUndo > maxRounds) {
+            cout << "Invalid entry." << endl;
+            continue;
+        }
+
+        int numChanged = session.undo(gameIndex, numRoundsToUndo);
+
+        // Format the analyses first, then display them with one write
+        ostringstream out;
+        out << numChanged << " games changed. Champion: " << session.getChampionshipGame().getWinner() << "\n";
+        for (int r = session.getMainRound() + 1; r <= session.getLastRound(); r++) {
+            pair<string, int> underdog = session.bestUnderdog(r);
+            string region = session.expectedChampionRegion(r);
+            out << "   Round " << r << ": best underdog " << underdog.first << " (rank " << underdog.second << ")";
+            if (!region.empty()) {
+                out << ", region expected to win " << region;
+            }
+            out << "\n";
+        }
+        if (!entryToUnique.empty()) {
+            out << "   Pool scores:";
+            for (int entry = 0; entry < entryToUnique.size(); entry++) {
+                out << " " << session.getPoolScores().at(entryToUnique.at(entry));
+            }
+            out << "\n";
+        }
+        cout << out.str();
+    }
+} // end whatIfSession()
+
+
+// Index of which teams could meet in which games, built from the shape of the bracket. Each team is a leaf of the
+// bracket, numbered from left to right, so the teams under any game are a range of leaf numbers. Each game keeps a
+// table of its ancestors (2^k games up), so the game where two teams would meet (their lowest common ancestor)
+// and the game a team would play in a given round are found in O(log n) steps.
+class HeadToHeadIndex {
+    public:
+        HeadToHeadIndex(Game &championshipGame) {
+            addGame(championshipGame, -1);
+
+            // up[k][node] is the game 2^k games above node, or the championship game
+            int numGames = games.size();
+            up.push_back(parent);
+            up.at(0).at(0) = 0;
+            for (int k = 1; (1 << k) < numGames; k++) {
+                vector<int> nextUp(numGames);
+                for (int node = 0; node < numGames; node++) {
+                    nextUp.at(node) = up.at(k - 1).at(up.at(k - 1).at(node));
+                }
+                up.push_back(nextUp);
+            }
+        }
+
+        int getNumTeams() { return leafTeam.size(); }
+        string getTeam(int leaf) { return leafTeam.at(leaf); }
+
+        // Leaf number of a team, or -1 if it is not in the bracket
+        int findTeam(string team) {
+            unordered_map<string, int>::iterator found = leafOfTeam.find(team);
+            return (found == leafOfTeam.end()) ? -1 : found->second;
+        }
+
+        // Round of the earliest game the two teams could play each other in
+        int earliestMeetingRound(int leafA, int leafB) {
+            return games.at(meetingGame(leafA, leafB)).getRoundNum();
+        }
+
+        // The game the two teams would play each other in if both kept winning
+        int meetingGame(int leafA, int leafB) {
+            int a = leafGame.at(leafA);
+            int b = leafGame.at(leafB);
+            if (isAncestor(a, b)) {
+                return a;
+            }
+            if (isAncestor(b, a)) {
+                return b;
+            }
+            for (int k = up.size() - 1; k >= 0; k--) {
+                if (!isAncestor(up.at(k).at(a), b)) {
+                    a = up.at(k).at(a);
+                }
+            }
+            return parent.at(a);
+        }
+
+        // The game the team would play in the given round if it kept winning, or -1 if it would not play in that round
+        int gameInRound(int leaf, int numRound) {
+            int node = leafGame.at(leaf);
+            if (games.at(node).getRoundNum() > numRound) {
+                return -1;
+            }
+            for (int k = up.size() - 1; k >= 0; k--) {
+                if (games.at(up.at(k).at(node)).getRoundNum() <= numRound) {
+                    node = up.at(k).at(node);
+                }
+            }
+            return (games.at(node).getRoundNum() == numRound) ? node : -1;
+        }
+
+        // The teams the team could play in the given round, as ranges [first, last) of leaf numbers: the teams under the
+        // game in that round, apart from the ones on the team's own side of it
+        vector< pair<int, int> > possibleOpponents(int leaf, int numRound) {
+            vector< pair<int, int> > ranges;
+            int node = gameInRound(leaf, numRound);
+            if (node == -1) {
+                return ranges;
+            }
+            int ownFirst = leaf, ownLast = leaf + 1;
+            int child = leafGame.at(leaf);
+            if (child != node) {
+                for (int k = up.size() - 1; k >= 0; k--) {
+                    if (games.at(up.at(k).at(child)).getRoundNum() < numRound) {
+                        child = up.at(k).at(child);
+                    }
+                }
+                ownFirst = leafFirst.at(child);
+                ownLast = leafLast.at(child);
+            }
+            if (leafFirst.at(node) < ownFirst) {
+                ranges.push_back(make_pair(leafFirst.at(node), ownFirst));
+            }
+            if (ownLast < leafLast.at(node)) {
+                ranges.push_back(make_pair(ownLast, leafLast.at(node)));
+            }
+            return ranges;
+        }
+
+        // The games the team would play on its way to the given game (whose position is found by findGame()), from its
+        // first game up to and including that game. Empty if the team is not under that game.
+        vector<Game> pathToGame(int leaf, int node) {
+            vector<Game> path;
+            if (node < 0 || leaf < leafFirst.at(node) || leaf >= leafLast.at(node)) {
+                return path;
+            }
+            for (int current = leafGame.at(leaf); current != node; current = parent.at(current)) {
+                path.push_back(games.at(current));
+            }
+            path.push_back(games.at(node));
+            return path;
+        }
+
+        // Position in the index of the game with the given round number and winning team, or -1
+        int findGame(int numRound, string winningTeam) {
+            for (int node = 0; node < games.size(); node++) {
+                if (games.at(node).getRoundNum() == numRound && games.at(node).getWinner() == winningTeam) {
+                    return node;
+                }
+            }
+            return -1;
+        }
+
+        // The earliest meeting round of every pair of teams at once, indexed by leaf number. Each game fills in the pairs
+        // of teams that come from different sides of it, so every pair is filled in exactly once.
+        vector< vector<int> > allMeetingRounds() {
+            vector< vector<int> > rounds(leafTeam.size(), vector<int>(leafTeam.size(), 0));
+            for (int node = 0; node < games.size(); node++) {
+                vector< pair<int, int> > &sides = sidesOfGame.at(node);
+                for (int s1 = 0; s1 < sides.size(); s1++) {
+                    for (int s2 = s1 + 1; s2 < sides.size(); s2++) {
+                        for (int a = sides.at(s1).first; a < sides.at(s1).second; a++) {
+                            for (int b = sides.at(s2).first; b < sides.at(s2).second; b++) {
+                                rounds.at(a).at(b) = games.at(node).getRoundNum();
+                                rounds.at(b).at(a) = games.at(node).getRoundNum();
+                            }
+                        }
+                    }
+                }
+            }
+            return rounds;
+        }
+
+    private:
+        // Add a game and the games under it, numbering the teams from left to right. Returns the game's position.
+        int addGame(Game &game, int parentNode) {
+            int node = games.size();
+            games.push_back(game);
+            parent.push_back(parentNode);
+            leafFirst.push_back(leafTeam.size());
+            leafLast.push_back(0);
+            leafGame.resize(leafTeam.size());
+            sidesOfGame.push_back(vector< pair<int, int> >());
+
+            // Each team in the game either comes from a sub-bracket (the one it won), or starts here
+            string teams[2] = {game.getTeamOneName(), game.getTeamTwoName()};
+            for (int t = 0; t < 2; t++) {
+                int sideFirst = leafTeam.size();
+                Node *currentNode = game.getSubBrackets();
+                while (currentNode != NULL && currentNode->subBracket.getWinner() != teams[t]) {
+                    currentNode = currentNode->pNext;
+                }
+                if (currentNode != NULL) {
+                    addGame(currentNode->subBracket, node);
+                } else {
+                    leafOfTeam[teams[t]] = leafTeam.size();
+                    leafTeam.push_back(teams[t]);
+                    leafGame.push_back(node);
+                }
+                sidesOfGame.at(node).push_back(make_pair(sideFirst, (int) leafTeam.size()));
+            }
+            leafLast.at(node) = leafTeam.size();
+            return node;
+        }
+
+        // Whether game a is game b or one of the games after it (every team under b is under a)
+        bool isAncestor(int a, int b) {
+            return leafFirst.at(a) <= leafFirst.at(b) && leafLast.at(b) <= leafLast.at(a);
+        }
+
+        vector<Game> games;                      // in the order they were added, from the championship down
+        vector<int> parent;                      // the game the winner plays next, or -1
+        vector<int> leafFirst, leafLast;         // range [first, last) of leaf numbers under each game
+        vector< vector< pair<int, int> > > sidesOfGame; // the range of leaf numbers of each team's side of each game
+        vector< vector<int> > up;                // [k][game] the game 2^k games above
+
+        vector<string> leafTeam;                 // team at each leaf
+        vector<int> leafGame;                    // first game of the team at each leaf
+        unordered_map<string, int> leafOfTeam;
+};
+
+
+//--------------------------------------------------------------------------------
+// Whether the team played in the game or in any of its sub-brackets
+bool teamIsInBracket(Game &game, string team)
+{
+    if (game.getTeamOneName() == team || game.getTeamTwoName() == team) {
+        return true;
+    }
+    for (Node *currentNode = game.getSubBrackets(); currentNode != NULL; currentNode = currentNode->pNext) {
+        if (teamIsInBracket(currentNode->subBracket, team)) {
+            return true;
+        }
+    }
+    return false;
+} // end teamIsInBracket()
+
+
+//--------------------------------------------------------------------------------
+// Earliest round two teams could meet in, by recursing through the sub-brackets the way findPathToChampionship() does:
+// go down into the sub-bracket with both teams for as long as there is one
+int findMeetingRoundByRecursion(Game &game, string teamA, string teamB)
+{
+    for (Node *currentNode = game.getSubBrackets(); currentNode != NULL; currentNode = currentNode->pNext) {
+        if (teamIsInBracket(currentNode->subBracket, teamA) && teamIsInBracket(currentNode->subBracket, teamB)) {
+            return findMeetingRoundByRecursion(currentNode->subBracket, teamA, teamB);
+        }
+    }
+    return game.getRoundNum();
+} // end findMeetingRoundByRecursion()
+
+
+// ----------------------------------------------------------------------
+// MENU OPTION 9 :: Head-to-head queries: when two teams could meet, who a team could play, and the path to a game
+void headToHead(TournamentVersion &version)
+{
+    HeadToHeadIndex index(version.championshipGame);
+
+    int inputQuery;
+    cout << "Enter a head-to-head query:\n"
+         << "   Select 1 for the earliest round two teams could meet in\n"
+         << "   Select 2 for the teams a team could play in a given round\n"
+         << "   Select 3 for the path a team would take to a given game\n"
+         << "   Select 4 to write the earliest meeting round of every pair of teams to a file\n"
+         << "Your choice --> ";
+    cin >> inputQuery;
+
+    string teamA, teamB;
+    if (inputQuery >= 1 && inputQuery <= 3) {
+        cout << "Enter the team: ";
+        cin.ignore();
+        getline(cin, teamA);
+        if (index.findTeam(teamA) == -1) {
+            cout << "Sorry, that team is not in the tournament.\n";
+            return;
+        }
+    }
+
+    if (inputQuery == 1) {
+        cout << "Enter the other team: ";
+        getline(cin, teamB);
+        if (index.findTeam(teamB) == -1 || teamB == teamA) {
+            cout << "Sorry, that team is not in the tournament.\n";
+            return;
+        }
+        cout << teamA << " and " << teamB << " could first meet in round "
+             << index.earliestMeetingRound(index.findTeam(teamA), index.findTeam(teamB)) << ".\n";
+    }
+    else if (inputQuery == 2) {
+        int numRound = 0;
+        cout << "Enter the round number: ";
+        cin >> numRound;
+        vector< pair<int, int> > ranges = index.possibleOpponents(index.findTeam(teamA), numRound);
+        if (ranges.empty()) {
+            cout << teamA << " would not play in round " << numRound << ".\n";
+            return;
+        }
+        ostringstream out;
+        out << "In round " << numRound << ", " << teamA << " could play:\n";
+        for (int r = 0; r < ranges.size(); r++) {
+            for (int leaf = ranges.at(r).first; leaf < ranges.at(r).second; leaf++) {
+                out << "   " << index.getTeam(leaf) << "\n";
+            }
+        }
+        cout << out.str();
+    }
+    else if (inputQuery == 3) {
+        int numRound = 0;
+        cout << "Enter the round number of the game: ";
+        cin >> numRound;
+        string winningTeam;
+        cout << "Enter the winning team of the game: ";
+        cin.ignore();
+        getline(cin, winningTeam);
+        int node = index.findGame(numRound, winningTeam);
+        if (node == -1) {
+            cout << "Sorry, no games matching that round number and winning team were found.\n";
+            return;
+        }
+        vector<Game> path = index.pathToGame(index.findTeam(teamA), node);
+        if (path.empty()) {
+            cout << teamA << " could not play in that game.\n";
+            return;
+        }
+        cout << "Path of " << teamA << " to the game:\n";
+        displayGames(path);
+    }
+    else if (inputQuery == 4) {
+        string fileName;
+        cout << "Enter the name of the file: ";
+        cin >> fileName;
+        ReportWriter report(fileName, REPORT_CSV, {"team1", "team2", "earliest-round"});
+        if (!report.isOpen()) {
+            cout << "Could not open " << fileName << ".\n";
+            return;
+        }
+        vector< vector<int> > rounds = index.allMeetingRounds();
+        for (int a = 0; a < rounds.size(); a++) {
+            for (int b = a + 1; b < rounds.size(); b++) {
+                report.writeRow({index.getTeam(a), index.getTeam(b), to_string(rounds.at(a).at(b))});
+            }
+        }
+        report.finish();
+        cout << "Wrote " << report.getNumRows() << " pairs of teams to " << fileName << ".\n";
+    } else {
+        cout << "Invalid value." << endl;
+    }
+} // end headToHead()
+
+
+//--------------------------------------------------------------------------------
+// Time the bulk undo evaluation with 1 thread up to one thread per core
+void benchmarkCounterfactualScaling(TournamentVersion &version)
+{
+    vector< vector<Game> > pool;
+    vector<int> entryToUnique;
+    readInPool(pool, entryToUnique);
+
+    // A single bracket only has about a hundred undos, so repeat the evaluation to get measurable times
+    const int numRepetitions = 200;
+    int maxThreads = defaultNumThreads();
+    double oneThreadMs = 0;
+
+    // 1, 2, 4, ... threads, always ending with one thread per core
+    vector<int> threadCounts;
+    for (int numThreads = 1; numThreads < maxThreads; numThreads *= 2) {
+        threadCounts.push_back(numThreads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    cout << "Threads    Time (ms)    Speedup\n";
+    for (int t = 0; t < threadCounts.size(); t++) {
+        int numThreads = threadCounts.at(t);
+        auto start = chrono::steady_clock::now();
+        for (int rep = 0; rep < numRepetitions; rep++) {
+            evaluateAllCounterfactuals(version, pool, numThreads);
+        }
+        double elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        if (numThreads == 1) {
+            oneThreadMs = elapsedMs;
+        }
+        cout << numThreads << "          " << elapsedMs << "        " << (oneThreadMs / elapsedMs) << "x\n";
+    }
+} // end benchmarkCounterfactualScaling()
+
+
+//--------------------------------------------------------------------------------
+// Time writing a large report line by line with endl, the way the menu options display games,
+// and with the report writer
+void benchmarkReportWriter(TournamentVersion &version)
+{
+    const int numRepetitions = 20000;
+    vector<Game> path = findPathToChampionship(version.championshipGame);
+    string fileName = "benchmark_report.csv";
+
+    auto start = chrono::steady_clock::now();
+    ofstream outStream(fileName);
+    if (outStream.fail()) {
+        cout << "Could not open " << fileName << " in the current directory.\n";
+        return;
+    }
+    for (int rep = 0; rep < numRepetitions; rep++) {
+        for (int i = 0; i < path.size(); i++) {
+            outStream << path.at(i).getRoundNum() << "," << path.at(i).getGameNum() << "," << path.at(i).getTeamOneName() << ","
+                      << path.at(i).getTeamTwoName() << "," << path.at(i).getWinner() << endl;
+        }
+    }
+    outStream.close();
+    double endlMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    ReportWriter report(fileName, REPORT_CSV, {"round", "game", "team1", "team2", "winner"});
+    if (!report.isOpen()) {
+        cout << "Could not open " << fileName << " in the current directory.\n";
+        return;
+    }
+    for (int rep = 0; rep < numRepetitions; rep++) {
+        for (int i = 0; i < path.size(); i++) {
+            report.writeRow({to_string(path.at(i).getRoundNum()), to_string(path.at(i).getGameNum()), path.at(i).getTeamOneName(),
+                             path.at(i).getTeamTwoName(), path.at(i).getWinner()});
+        }
+    }
+    report.finish();
+    double writerMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << "Writing " << report.getNumRows() << " rows:\n"
+         << "endl after every line:  " << endlMs << " ms\n"
+         << "report writer:          " << writerMs << " ms, " << endlMs / writerMs << "x faster\n";
+    remove(fileName.c_str());
+} // end benchmarkReportWriter()
+
+
+//--------------------------------------------------------------------------------
+// Time repeated undo-then-query cycles on a private bracket, rescanning every game after each undo and
+// updating only the games that changed, and check that both ways give the same answers
+void benchmarkIncrementalUndo(TournamentVersion &version)
+{
+    const int numEntries = 5000;
+    const int numCycles = 1000;
+    vector<Game> &games = version.loaded->games;
+
+    // A synthetic pool: each entry picks either team of each game at random
+    mt19937 generator(2022);
+    vector< vector<Game> > pool(numEntries, games);
+    for (int entry = 0; entry < numEntries; entry++) {
+        for (int i = 0; i < games.size(); i++) {
+            Game &game = pool.at(entry).at(i);
+            game.setWinner((generator() % 2 == 0) ? game.getTeamOneName() : game.getTeamTwoName());
+        }
+    }
+
+    // The same random undos for both ways
+    vector< pair<int, int> > undos;
+    for (int cycle = 0; cycle < numCycles; cycle++) {
+        int gameIndex = generator() % games.size();
+        int numRounds = 1 + generator() % countRoundsPlayed(games.at(gameIndex));
+        undos.push_back(make_pair(gameIndex, numRounds));
+    }
+
+    // Query everything after each undo, and keep the answers to compare
+    auto query = [&](IncrementalBracket &session, vector<string> &answers) {
+        string answer = session.getChampionshipGame().getWinner();
+        for (int r = session.getMainRound() + 1; r <= session.getLastRound(); r++) {
+            answer += "," + session.expectedChampionRegion(r) + "," + session.bestUnderdog(r).first;
+        }
+        vector<int> &scores = session.getPoolScores();
+        long total = 0;
+        for (int entry = 0; entry < scores.size(); entry++) {
+            total = total * 31 + scores.at(entry);
+        }
+        answers.push_back(answer + "," + to_string(total));
+    };
+
+    vector<string> rescanAnswers, incrementalAnswers;
+    long numChanged = 0;
+
+    IncrementalBracket rescanSession(version, pool);
+    auto start = chrono::steady_clock::now();
+    for (int cycle = 0; cycle < numCycles; cycle++) {
+        rescanSession.undoAndRecomputeAll(undos.at(cycle).first, undos.at(cycle).second);
+        query(rescanSession, rescanAnswers);
+    }
+    double rescanMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    IncrementalBracket incrementalSession(version, pool);
+    start = chrono::steady_clock::now();
+    for (int cycle = 0; cycle < numCycles; cycle++) {
+        numChanged += incrementalSession.undo(undos.at(cycle).first, undos.at(cycle).second);
+        query(incrementalSession, incrementalAnswers);
+    }
+    double incrementalMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << numCycles << " undo-then-query cycles with a pool of " << numEntries << " entries:\n"
+         << "rescan every game:         " << rescanMs << " ms\n"
+         << "update changed games only: " << incrementalMs << " ms, " << rescanMs / incrementalMs << "x faster ("
+         << (double) numChanged / numCycles << " of " << games.size() << " games changed per undo)\n"
+         << (rescanAnswers == incrementalAnswers ? "Both give the same answers.\n" : "The answers DIFFER.\n");
+} // end benchmarkIncrementalUndo()
+
+
+//--------------------------------------------------------------------------------
+// Time finding the earliest meeting round of every pair of teams by recursing through the sub-brackets,
+// with one lookup in the head-to-head index per pair, and with the whole matrix at once
+void benchmarkHeadToHead(TournamentVersion &version)
+{
+    const int numRepetitions = 100;
+
+    auto start = chrono::steady_clock::now();
+    HeadToHeadIndex index(version.championshipGame);
+    double buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    int numTeams = index.getNumTeams();
+
+    // Recursion is much slower, so it only goes through the pairs once
+    start = chrono::steady_clock::now();
+    vector< vector<int> > recursionRounds(numTeams, vector<int>(numTeams, 0));
+    for (int a = 0; a < numTeams; a++) {
+        for (int b = a + 1; b < numTeams; b++) {
+            recursionRounds.at(a).at(b) = recursionRounds.at(b).at(a) =
+                findMeetingRoundByRecursion(version.championshipGame, index.getTeam(a), index.getTeam(b));
+        }
+    }
+    double recursionMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    vector< vector<int> > lookupRounds(numTeams, vector<int>(numTeams, 0));
+    start = chrono::steady_clock::now();
+    for (int rep = 0; rep < numRepetitions; rep++) {
+        for (int a = 0; a < numTeams; a++) {
+            for (int b = a + 1; b < numTeams; b++) {
+                lookupRounds.at(a).at(b) = lookupRounds.at(b).at(a) = index.earliestMeetingRound(a, b);
+            }
+        }
+    }
+    double lookupMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / numRepetitions;
+
+    vector< vector<int> > batchRounds;
+    start = chrono::steady_clock::now();
+    for (int rep = 0; rep < numRepetitions; rep++) {
+        batchRounds = index.allMeetingRounds();
+    }
+    double batchMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / numRepetitions;
+
+    cout << "Earliest meeting round of all " << numTeams * (numTeams - 1) / 2 << " pairs of " << numTeams << " teams:\n"
+         << "building the index:          " << buildMs << " ms\n"
+         << "recursion for each pair:     " << recursionMs << " ms\n"
+         << "index lookup for each pair:  " << lookupMs << " ms, " << recursionMs / lookupMs << "x faster\n"
+         << "whole matrix at once:        " << batchMs << " ms, " << recursionMs / batchMs << "x faster\n"
+         << ((recursionRounds == lookupRounds && lookupRounds == batchRounds) ? "All three give the same rounds.\n"
+                                                                           : "The rounds DIFFER.\n");
+} // end benchmarkHeadToHead()
+
+
+//--------------------------------------------------------------------------------
+// Run reader threads that query and score the current version while a writer keeps undoing and reloading it.
+// Every reader checks that each version it sees is consistent: the path has one game per round and the
+// champion won every game on it. The test uses its own store read in from the file, so the
+// tournament being analyzed from the menu is left as it was.
+void stressTestConcurrentReaders(string fileName)
+{
+    TournamentStore store;
+    store.reload(fileName);
+
+    const int numReaders = max(2, defaultNumThreads());
+    const int numSeconds = 3;
+    string championshipKey = gameKey(store.acquire()->championshipGame);
+    int maxRounds = countRoundsPlayed(store.acquire()->championshipGame);
+
+    atomic<bool> done(false);
+    atomic<long> numReads(0), numWrites(0), numInconsistent(0);
+
+    auto reader = [&]() {
+        while (!done) {
+            shared_ptr<TournamentVersion> version = store.acquire();
+
+            vector<Game> path = findPathToChampionship(version->championshipGame);
+            string champion = version->championshipGame.getWinner();
+
+            // The path has to end at the championship game, with the champion winning every game in it, one round after another
+            bool consistent = (gameKey(path.back()) == championshipKey);
+            for (int i = 0; i < path.size(); i++) {
+                if (path.at(i).getWinner() != champion || (i > 0 && path.at(i).getRoundNum() <= path.at(i - 1).getRoundNum())) {
+                    consistent = false;
+                }
+            }
+            // Also score the version's winners the way a pool entry would, which reads every game in it
+            vector<Game> &games = version->loaded->games;
+            map<string, int> gameIndexByKey;
+            for (int i = 0; i < games.size(); i++) {
+                gameIndexByKey[gameKey(games.at(i))] = i;
+            }
+            vector<string> winners(games.size());
+            collectWinners(version->championshipGame, gameIndexByKey, winners);
+            if (scorePrediction(games, winners, games) < 0 || find(winners.begin(), winners.end(), "") != winners.end()) {
+                consistent = false;
+            }
+
+            if (!consistent) {
+                numInconsistent++;
+            }
+            numReads++;
+        }
+    };
+
+    vector<thread> readers;
+    for (int t = 0; t < numReaders; t++) {
+        readers.push_back(thread(reader));
+    }
+
+    // The writer alternates between undos of random depth and reloads of the file
+    mt19937 generator(2022);
+    uniform_int_distribution<int> numRoundsDistribution(1, maxRounds);
+    auto stopTime = chrono::steady_clock::now() + chrono::seconds(numSeconds);
+    while (chrono::steady_clock::now() < stopTime) {
+        if (numWrites % 10 == 9) {
+            store.reload(fileName);
+        } else {
+            store.undo(numRoundsDistribution(generator));
+        }
+        numWrites++;
+    }
+
+    done = true;
+    for (int t = 0; t < readers.size(); t++) {
+        readers.at(t).join();
+    }
+
+    cout << numReaders << " readers made " << numReads << " reads while " << numWrites << " versions were published in "
+         << numSeconds << " seconds.\n"
+         << numInconsistent << " inconsistent versions were seen.\n";
+} // end stressTestConcurrentReaders()
+
+
+// ----------------------------------------------------------------------
+// MENU OPTION 5 :: Run performance benchmarks and stress tests
+void runBenchmarks(TournamentStore &store, string fileName)
+{
+    int inputBenchmark;
+    cout << "Enter a benchmark to run:\n"
+         << "   Select 1 for bulk undo evaluation scaling from 1 to " << defaultNumThreads() << " threads\n"
+         << "   Select 2 for a stress test of concurrent readers while the tournament is undone and reloaded\n"
+         << "   Select 3 for writing a large report with endl after every line and with the report writer\n"
+         << "   Select 4 for repeated undos and queries, rescanning every game and updating only the changed games\n"
+         << "   Select 5 for the earliest meeting round of every pair of teams, by recursion and with the head-to-head index\n"
+         << "Your choice --> ";
+    cin >> inputBenchmark;
+
+    if (inputBenchmark == 1) {
+        shared_ptr<TournamentVersion> version = store.acquire();
+        benchmarkCounterfactualScaling(*version);
+    }
+    else if (inputBenchmark == 2) {
+        stressTestConcurrentReaders(fileName);
+    }
+    else if (inputBenchmark == 3) {
+        shared_ptr<TournamentVersion> version = store.acquire();
+        benchmarkReportWriter(*version);
+    }
+    else if (inputBenchmark == 4) {
+        shared_ptr<TournamentVersion> version = store.acquire();
+        benchmarkIncrementalUndo(*version);
+    }
+    else if (inputBenchmark == 5) {
+        shared_ptr<TournamentVersion> version = store.acquire();
+        benchmarkHeadToHead(*version);
+    } else {
+        cout << "Invalid value." << endl;
+    }
+} // end runBenchmarks()
+
+
+// ----------------------------------------------------------------------
+// Main() function of the program
+int main()
+{
+    // Holds the current version of the tournament games
+    TournamentStore store;
+
+    displayWelcomeMessage();
+
+    // Prompt user for the name of the file with the data, prompting again until the file can be used
+    string fileName;
+    while (true) {
+        cout << "Enter the name of the file with the data for the NCAA tournament: ";
+        cin >> fileName;
+        if (!cin) {
+            return 0;
+        }
+
+        // Read in the data from the file, identify sub-brackets for each game, and publish it
+        if (store.reload(fileName)) {
+            break;
+        }
+        cout << "Please fix the lines listed above or choose another file.\n";
+    }
+  
+    // Infinite loop to allow handling menu options
+    int menuOption = 0;
+    while (true) {
+        // Hold on to the current version while handling this menu option
+        shared_ptr<TournamentVersion> version = store.acquire();
+        vector<Game> &games = version->loaded->games;
+        Game &championshipGame = version->championshipGame;
+
+        // Prompt user for menu selection
+        cout << "\nSelect a menu option:\n"
+             << "   1. See the sub-brackets of one game\n"
+             << "   2. Display the path of the winning team to the championship\n"
+             << "   3. Undo the championship game for a given number of rounds\n"
+             << "   4. Evaluate every undo for every game at once\n"
+             << "   5. Run performance benchmarks and stress tests\n"
+             << "   6. Read in a different tournament file\n"
+             << "   7. Write reports for every game, team and pool entry to files\n"
+             << "   8. Undo games one after another and see how the analyses and pool scores change\n"
+             << "   9. See when teams could meet, who a team could play, and the path a team would take to a game\n"
+             << "   10. Exit\n"
+             << "Your choice --> ";
+        cin >> menuOption;
+
+        // If option 10 was chosen then exit the program
+        if (menuOption == 10) {
+            cout << "Exiting program...";
+            break;     // Break out of loop to exit program.
+        }
+
+        if (menuOption == 1) {
+            displaySubBrackets(games);
+            continue;
+        }
+
+        else if (menuOption == 2) {
+            cout << "Path to the championship:\n";
+            vector<Game> path = findPathToChampionship(championshipGame);
+            displayGames(path);
+            continue;
+        }
+
+        else if (menuOption == 3) {
+            int numRoundsToUndo = 0;  
+            int maxRounds = countRoundsPlayed(championshipGame);
+            do {
+                cout << "Enter the number of rounds that you would like to undo (max of " << maxRounds << " allowed): ";
+                cin >> numRoundsToUndo;
+                cout << endl;
+                if (numRoundsToUndo < 1 || numRoundsToUndo > maxRounds) {
+                    cout << "Invalid entry. Try again." << endl;
+                }
+            } while (numRoundsToUndo < 1 || numRoundsToUndo > maxRounds);
+
+          
+            // Work backwards from championship up for number of inputted rounds, publishing a new version
+            store.undo(numRoundsToUndo);
+            version = store.acquire();
+
+            // Display new path to championship, up to and including the championship game
+            vector<Game> path = findPathToChampionship(version->championshipGame);
+            displayGames(path);
+            continue;
+        }
+
+        else if (menuOption == 4) {
+            displayAllCounterfactuals(*version);
+            continue;
+        }
+
+        else if (menuOption == 5) {
+            runBenchmarks(store, fileName);
+            continue;
+        }
+
+        else if (menuOption == 6) {
+            string newFileName;
+            cout << "Enter the name of the file with the data for the NCAA tournament: ";
+            cin >> newFileName;
+            if (store.reload(newFileName)) {
+                fileName = newFileName;
+            } else {
+                cout << "The tournament from " << fileName << " is still being used.\n";
+            }
+            continue;
+        }
+
+        else if (menuOption == 7) {
+            writeBatchReports(*version);
+            continue;
+        }
+
+        else if (menuOption == 8) {
+            whatIfSession(*version);
+            continue;
+        }
 
-            // Display new path to championship
-            findPathToChampionship(championshipGame);
-            // Display the championship game
-            championshipGame.displayGame();
+        else if (menuOption == 9) {
+            headToHead(*version);
             continue;
         }
 